@@ -1,12 +1,45 @@
 #include "adj_list.h"
 #include "parlay/parallel.h"
+#include "parlay/primitives.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <cinttypes>
+#include <limits>
+#include <tuple>
 
 typedef libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> Edge;
 typedef libcuckoo::cuckoohash_map<uint64_t, libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>>> NestedMap;
 
+namespace {
+
+/**
+ * Shrinks an outer table after an eviction once it is less than an eighth full. Resizing rehashes the whole table
+ * under all of its locks, so sparse tables are shrunk to four times their size, which leaves room to grow again, and
+ * never below the size the table was created with.
+ * @param table outer table keyed by timestamp
+ */
+template<typename Table>
+void shrinkIfSparse(Table &table) {
+    if (table.capacity() <= libcuckoo::DEFAULT_SIZE || table.load_factor() >= 0.125) return;
+    table.reserve(std::max<size_t>(table.size() * 4, libcuckoo::DEFAULT_SIZE));
+}
+
+/**
+ * Returns the bitmap of a timestamp for modification, must be called under the lock of the timestamp. A bitmap that
+ * getVertexBitmap still merges is copied first, so readers never see it change.
+ * @param bitmap entry of vertexBitmaps, empty for a new timestamp
+ * @return bitmap that is only referenced by the table
+ */
+VertexBitmap &writableBitmap(std::shared_ptr<VertexBitmap> &bitmap) {
+    if (!bitmap) bitmap = std::make_shared<VertexBitmap>();
+    else if (bitmap.use_count() > 1) bitmap = std::make_shared<VertexBitmap>(*bitmap);
+    return *bitmap;
+}
+
+}
+
 /**
  * Checks if the given edge exists in the graph.
  * @param source node of the edge
@@ -46,6 +79,77 @@ bool AdjList::findEdge(uint64_t source, uint64_t destination, uint64_t start, ui
     return flag;
 }
 
+/**
+ * Resolves @p n lookups of (time, source) at once. The lookups are sorted by time and source and split into chunks
+ * that run in parallel, so consecutive lookups of a chunk hit the same outer bucket and partition while they are
+ * still cached. Every lookup is a find_fn on the outer table followed by a find_fn on the partition, so only the
+ * buckets of one key are locked at a time and writers are never blocked for the whole batch.
+ * @param n number of lookups
+ * @param getTime returns the timestamp of lookup i
+ * @param getSource returns the source of lookup i
+ * @param f called with (i, destinations of lookup i or nullptr) while the buckets of lookup i are locked, so it must
+ * not access the graph
+ */
+template<typename GetTime, typename GetSource, typename F>
+void AdjList::lookupBatch(size_t n, GetTime &&getTime, GetSource &&getSource, F &&f) {
+    constexpr size_t chunkSize = 1024;
+
+    auto order = parlay::tabulate(n, [](size_t i) { return i; });
+    parlay::sort_inplace(order, [&](size_t a, size_t b) {
+        return std::make_pair(getTime(a), getSource(a)) < std::make_pair(getTime(b), getSource(b));
+    });
+
+    parlay::parallel_for(0, (n + chunkSize - 1) / chunkSize, [&](size_t c) {
+        size_t begin = c * chunkSize;
+        size_t end = std::min(n, begin + chunkSize);
+        for (size_t i = begin; i < end; i++) {
+            bool found = false;
+            edges.find_fn(getTime(order[i]), [&](const Edge &innerTbl) {
+                innerTbl.find_fn(getSource(order[i]), [&](const std::vector<uint64_t> &destinations) {
+                    found = true;
+                    f(order[i], &destinations);
+                });
+            });
+            if (!found) f(order[i], nullptr);
+        }
+    }, 1);
+}
+
+/**
+ * Checks many edges at once, see lookupBatch.
+ * @param keys edges to be checked
+ * @return result[i] is true if keys[i] exists in the graph
+ */
+parlay::sequence<bool> AdjList::findEdges(const std::vector<EdgeKey> &keys) {
+    parlay::sequence<bool> found(keys.size(), false);
+    lookupBatch(keys.size(),
+                [&keys](size_t i) { return keys[i].time; },
+                [&keys](size_t i) { return keys[i].source; },
+                [&](size_t i, const std::vector<uint64_t> *destinations) {
+                    if (destinations) {
+                        uint64_t destination = keys[i].destination;
+                        found[i] = std::find(destinations->begin(), destinations->end(), destination) != destinations->end();
+                    }
+                });
+    return found;
+}
+
+/**
+ * Looks up the number of destinations for many (timestamp, source) pairs at once, see lookupBatch.
+ * @param keys pairs of timestamp and source
+ * @return result[i] is the number of destinations of keys[i], 0 if it has none
+ */
+parlay::sequence<uint64_t> AdjList::getDestSizes(const std::vector<std::pair<uint64_t, uint64_t>> &keys) {
+    parlay::sequence<uint64_t> sizes(keys.size(), 0);
+    lookupBatch(keys.size(),
+                [&keys](size_t i) { return keys[i].first; },
+                [&keys](size_t i) { return keys[i].second; },
+                [&](size_t i, const std::vector<uint64_t> *destinations) {
+                    if (destinations) sizes[i] = destinations->size();
+                });
+    return sizes;
+}
+
 /**
  * Inserts an edge into the given nested cuckoo map @p map.
  * @param source node of the edge
@@ -54,70 +158,170 @@ bool AdjList::findEdge(uint64_t source, uint64_t destination, uint64_t start, ui
  * @param map
  */
 void AdjList::insertEdgeDirected(uint64_t source, uint64_t destination, uint64_t time, NestedMap &map) {
-    if (map.contains(time)) {
-        map.update_fn(time,
-                      [&source, &destination](Edge &e) {
-                          e.upsert(source,
-                                   [&destination](std::vector<uint64_t> &d) { d.push_back(destination); },
-                                   std::vector<uint64_t>{destination});
-                      });
-    } else {
-        Edge e;
-        e.insert(source, std::vector<uint64_t>{destination});
-        map.insert(time, e);
+    //upsert instead of contains + insert, otherwise two threads can both create the timestamp and one edge is lost
+    map.upsert(time,
+               [&source, &destination](Edge &e, libcuckoo::UpsertContext) {
+                   e.upsert(source,
+                            [&destination](std::vector<uint64_t> &d, libcuckoo::UpsertContext) {
+                                d.push_back(destination);
+                            });
+               });
+}
+
+/**
+ * Inserts @p source -> @p destination into the graph unless it already exists. The check and the insertion happen
+ * under the lock of the source, so several threads may insert into the same timestamp. Afterwards marks @p source in
+ * the vertex bitmap of @p time and updates the counters of @p time, outside the lock of the timestamp.
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param time timestamp of the edge
+ * @return true if the edge was inserted
+ */
+bool AdjList::insertEdgeDirectedUnique(uint64_t source, uint64_t destination, uint64_t time) {
+    bool inserted = false;
+    PartitionDelta delta;
+    edges.upsert(time, [&](Edge &e, libcuckoo::UpsertContext) {
+        inserted = insertIntoPartition(e, source, destination, delta);
+    });
+    if (inserted) applyDelta(time, delta);
+    return inserted;
+}
+
+/**
+ * Inserts @p source -> @p destination into one timestamp unless it already exists. Only takes the locks of the inner
+ * map, the changes to the counters and the vertex bitmap are collected in @p delta.
+ * @param e inner map of the timestamp
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param delta collects the changes
+ * @return true if the edge was inserted
+ */
+bool AdjList::insertIntoPartition(Edge &e, uint64_t source, uint64_t destination, PartitionDelta &delta) {
+    bool inserted = false;
+    e.upsert(source, [&](std::vector<uint64_t> &d, libcuckoo::UpsertContext context) {
+        if (std::find(d.begin(), d.end(), destination) != d.end()) return;
+        size_t capacity = d.capacity();
+        d.push_back(destination);
+        inserted = true;
+        delta.gained.edges++;
+        delta.gained.bytes += (d.capacity() - capacity) * sizeof(uint64_t);
+        if (context == libcuckoo::UpsertContext::NEWLY_INSERTED) {
+            delta.gained.sources++;
+            delta.gained.bytes += sizeof(uint64_t) + sizeof(std::vector<uint64_t>);
+            delta.addedSources.push_back(source);
+        }
+    });
+    return inserted;
+}
+
+/**
+ * Deletes @p source -> @p destination from one timestamp and removes the source once it has no destinations left.
+ * Only takes the locks of the inner map, the changes to the counters and the vertex bitmap are collected in @p delta.
+ * @param e inner map of the timestamp
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param delta collects the changes
+ * @return true if the edge was deleted
+ */
+bool AdjList::eraseFromPartition(Edge &e, uint64_t source, uint64_t destination, PartitionDelta &delta) {
+    bool erased = false;
+    e.erase_fn(source, [&](std::vector<uint64_t> &d) {
+        auto it = std::find(d.begin(), d.end(), destination);
+        if (it == d.end()) return false;
+        d.erase(it);
+        erased = true;
+        delta.lost.edges++;
+        if (!d.empty()) return false;
+        delta.lost.sources++;
+        delta.lost.bytes += d.capacity() * sizeof(uint64_t) + sizeof(uint64_t) + sizeof(std::vector<uint64_t>);
+        delta.removedSources.push_back(source);
+        return true;
+    });
+    return erased;
+}
+
+/**
+ * Applies the changes collected for one timestamp to its vertex bitmap and counters, one locked update each.
+ * @param time timestamp that was changed
+ * @param delta changes of the timestamp
+ */
+void AdjList::applyDelta(uint64_t time, const PartitionDelta &delta) {
+    if (!delta.addedSources.empty()) {
+        vertexBitmaps.upsert(time, [&](std::shared_ptr<VertexBitmap> &b, libcuckoo::UpsertContext) {
+            VertexBitmap &bitmap = writableBitmap(b);
+            for (uint64_t source: delta.addedSources) bitmap.add(source);
+        });
+    }
+    if (!delta.removedSources.empty()) {
+        vertexBitmaps.update_fn(time, [&](std::shared_ptr<VertexBitmap> &b) {
+            VertexBitmap &bitmap = writableBitmap(b);
+            for (uint64_t source: delta.removedSources) bitmap.remove(source);
+        });
+    }
+    auto update = [&](TimestampStats &stats) {
+        stats.edges = stats.edges + delta.gained.edges - delta.lost.edges;
+        stats.sources = stats.sources + delta.gained.sources - delta.lost.sources;
+        stats.bytes = stats.bytes + delta.gained.bytes - delta.lost.bytes;
+    };
+    if (delta.gained.edges > 0) {
+        timestampStats.upsert(time, [&](TimestampStats &stats, libcuckoo::UpsertContext) { update(stats); });
+    } else if (delta.lost.edges > 0) {
+        timestampStats.update_fn(time, update);
     }
 }
 
 /**
- * Checks if the given edge to be inserted is already in the graph. If not, calls insertEdgeDirected twice to insert the
- * the edge in both directions (@p source -> @p destination and @p destination -> @p source).
- * @see AdjList::insertEdgeDirected
+ * Inserts the edge in both directions (@p source -> @p destination and @p destination -> @p source) unless it is
+ * already in the graph.
+ * @see AdjList::insertEdgeDirectedUnique
  * @param source node of the edge
  * @param destination node of the edge
  * @param time timestamp of the edge
  */
 void AdjList::insertEdgeUndirected(uint64_t source, uint64_t destination, uint64_t time) {
-    //filters out duplicates
-    if (findEdge(source, destination, time)) return;
-
-    //insert edges from source
-    insertEdgeDirected(source, destination, time, edges);
+    //insert edges from source, filters out duplicates
+    if (!insertEdgeDirectedUnique(source, destination, time)) return;
     //insert edges from destination
-    insertEdgeDirected(destination, source, time, edges);
+    insertEdgeDirectedUnique(destination, source, time);
 }
 
 /**
- * Deletes the given edge from the graph. Functions similar to insertEdgeDirected.
- * Also removes keys if their values are empty.
+ * Deletes the given edge from the graph. Functions similar to insertEdgeDirectedUnique.
+ * Also removes keys if their values are empty. The edge is deleted under the lock of its source, so concurrent
+ * deletions within the same timestamp are safe.
  * @param source node of the edge
  * @param destination node of the edge
  * @param time timestamp of the edge
  */
 void AdjList::deleteEdgeDirected(uint64_t source, uint64_t destination, uint64_t time) {
-    bool isDestinationEmpty = false;
-    bool isEdgeEmpty = false;
-
-    if (edges.contains(time)) {
+    bool erased = false;
+    PartitionDelta delta;
+    edges.update_fn(time, [&](Edge &e) {
+        erased = eraseFromPartition(e, source, destination, delta);
+    });
+    if (!erased) return;
+    applyDelta(time, delta);
+    //causes performance issues, so only checked after a source was removed
+    if (!delta.removedSources.empty()) eraseIfEmpty(time);
+}
 
-        edges.update_fn(time, [&isDestinationEmpty, &source, &destination](Edge &e) {
-            e.update_fn(source, [&isDestinationEmpty, &destination](std::vector<uint64_t> &d) {
-                d.erase(std::find(d.begin(), d.end(), destination));
-                if (d.empty()) isDestinationEmpty = true;
-            });
-        });
-        //delete source node if it has no edges (destinations)
-        if (isDestinationEmpty) {
-            edges.find_fn(time, [&isEdgeEmpty, &source](Edge &e) {
-                e.erase(source);
-                //causes performance issues
-                if (e.empty()) isEdgeEmpty = true;
-            });
-        }
-        //delete timestamp if edges is empty
-        if (isEdgeEmpty) {
-            edges.erase(time);
-            uniqueTimestamps.erase(time);
+/**
+ * Removes @p time from the graph if it has no edges left.
+ * @param time timestamp to be checked
+ */
+void AdjList::eraseIfEmpty(uint64_t time) {
+    bool erased = false;
+    edges.erase_fn(time, [&](Edge &e) {
+        erased = e.empty();
+        if (erased) {
+            vertexBitmaps.erase(time);
+            timestampStats.erase(time);
         }
+        return erased;
+    });
+    if (erased) {
+        std::lock_guard<std::mutex> guard(timestampsMutex);
+        uniqueTimestamps.erase(time);
     }
 }
 
@@ -137,6 +341,22 @@ void AdjList::deleteEdgeUndirected(uint64_t source, uint64_t destination, uint64
     deleteEdgeDirected(destination, source, time);
 }
 
+/**
+ * Inserts or deletes only the direction @p source -> @p destination. Used by ShardedAdjList, which stores every
+ * direction of an edge in the shard of its source. The caller is responsible for registering new timestamps.
+ * @param insert dictates whether to insert or delete the edge
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param time timestamp of the edge
+ * @return true if the graph was changed
+ */
+bool AdjList::applyDirected(bool insert, uint64_t source, uint64_t destination, uint64_t time) {
+    if (insert) return insertEdgeDirectedUnique(source, destination, time);
+    if (!findEdge(source, destination, time)) return false;
+    deleteEdgeDirected(source, destination, time);
+    return true;
+}
+
 /**
  * Prints all timestamps and the edge contained in them.
  */
@@ -168,18 +388,15 @@ void AdjList::printGraph() {
  * @param sourceVector container for all read sources with the same command.
  * @param destinationVector container for all read destinations with the same command.
  * @param timeVector container for all read timestamps with the same command.
- * @param uniqueTimes container for all read unique timestamps with the same command.
  * @param source value to be inserted
  * @param destination value to be inserted
  * @param time value to be inserted
  */
 void AdjList::fileReaderHelper(std::vector<uint64_t> &sourceVector, std::vector<uint64_t> &destinationVector,
-                               std::vector<uint64_t> &timeVector, std::set<uint64_t> &uniqueTimes,
-                               uint64_t source, uint64_t destination, uint64_t time){
+                               std::vector<uint64_t> &timeVector, uint64_t source, uint64_t destination, uint64_t time){
     sourceVector.push_back(source);
     destinationVector.push_back(destination);
     timeVector.push_back(time);
-    uniqueTimes.insert(time);
 }
 
 /**
@@ -189,6 +406,7 @@ void AdjList::fileReaderHelper(std::vector<uint64_t> &sourceVector, std::vector<
  * @param insert determines whether to insert or delete from uniqueTimestamps
  */
 void AdjList::uniqueTimesHelper(std::unordered_map<uint64_t, uint64_t> &uniqueTimesMap, std::set<uint64_t> &uniqueTimes, bool insert){
+    std::lock_guard<std::mutex> guard(timestampsMutex);
     int i = 0;
     for (const uint64_t &time: uniqueTimes) {
         uniqueTimesMap[i] = time;
@@ -198,6 +416,33 @@ void AdjList::uniqueTimesHelper(std::unordered_map<uint64_t, uint64_t> &uniqueTi
 }
 
 
+/**
+ * Groups the given edges by timestamp and inserts or deletes them with batchOperationParlay. After an insertion the
+ * retention window is applied. Batches of several threads are serialized on batchMutex together with their parlay
+ * work, parlay runs the work of all threads outside of its workers on the deque of worker 0.
+ * @param insert dictates whether to insert or delete the given edges
+ * @param sources list of source nodes
+ * @param destinations list of destination nodes
+ * @param times list of timestamps
+ */
+void AdjList::applyBatch(bool insert, const std::vector<uint64_t> &sources, const std::vector<uint64_t> &destinations,
+                         const std::vector<uint64_t> &times) {
+    std::set<uint64_t> uniqueTimes(times.begin(), times.end());
+    std::unordered_map<uint64_t, uint64_t> uniqueTimesMap;
+    uniqueTimesHelper(uniqueTimesMap, uniqueTimes, insert);
+
+    //Create new hash map, keys are timestamps,values are Edges (source, <destination>).
+    //This is then filled by sortBatch function.
+    NestedMap groupedData;
+    sortBatch(sources, destinations, times, groupedData);
+    batchOperationParlay(insert, groupedData, uniqueTimesMap);
+
+    if (insert && retentionWindow > 0 && !uniqueTimes.empty()) {
+        uint64_t newest = *uniqueTimes.rbegin();
+        if (newest >= retentionWindow) evictBefore(newest - retentionWindow + 1);
+    }
+}
+
 /**
  * Reads and extracts data from the file and calls functions to use the data on the graph.
  * @param path input file
@@ -209,32 +454,19 @@ void AdjList::addFromFile(const std::string &path) {
         uint64_t source, destination, time;
         std::vector<uint64_t> sourceAdds{}, destinationAdds{}, timeAdds{};
         std::vector<uint64_t> sourceDels{}, destinationDels{}, timeDels{};
-        std::set<uint64_t> uniqueTimesAdd, uniqueTimesDel;
-        std::unordered_map<uint64_t, uint64_t> uniqueTimesAddMap, uniqueTimesDelMap;
 
         while (file >> command >> source >> destination >> time) {
             if (command == "add") {
-                fileReaderHelper(sourceAdds, destinationAdds, timeAdds, uniqueTimesAdd, source, destination, time);
+                fileReaderHelper(sourceAdds, destinationAdds, timeAdds, source, destination, time);
             }
             if (command == "delete") {
-                fileReaderHelper(sourceDels, destinationDels, timeDels, uniqueTimesDel, source, destination, time);
+                fileReaderHelper(sourceDels, destinationDels, timeDels, source, destination, time);
             }
         }
         file.close();
 
-        uniqueTimesHelper(uniqueTimesAddMap, uniqueTimesAdd, true);
-        uniqueTimesHelper(uniqueTimesDelMap, uniqueTimesDel, false);
-
-
-        //Create new hash map, keys are timestamps,values are Edges (source, <destination>).
-        //This is then filled by sortBatch function.
-        libcuckoo::cuckoohash_map<uint64_t, Edge> groupedDataAdds, groupedDataDels;
-
-        sortBatch(sourceAdds, destinationAdds, timeAdds, groupedDataAdds);
-        batchOperationParlay(true, groupedDataAdds, uniqueTimesAddMap);
-
-        sortBatch(sourceDels, destinationDels, timeDels, groupedDataDels);
-        batchOperationParlay(false, groupedDataDels, uniqueTimesDelMap);
+        applyBatch(true, sourceAdds, destinationAdds, timeAdds);
+        applyBatch(false, sourceDels, destinationDels, timeDels);
 
         auto f = [](uint64_t a, uint64_t b, uint64_t c) {
             //printf("    - RangeQueryTest between: %" PRIu64 " and %" PRIu64 " at time %" PRIu64 "\n", b, c, a);
@@ -251,19 +483,44 @@ void AdjList::addFromFile(const std::string &path) {
  */
 void AdjList::batchOperation(bool insert, NestedMap &groupedData) {
     auto t1 = std::chrono::high_resolution_clock::now();
+    std::lock_guard<std::mutex> writer(batchMutex);
     auto lt = groupedData.lock_table();
 
+    std::vector<uint64_t> touchedTimes;
+    std::vector<std::vector<uint64_t>> touchedSources;
+    parlay::sequence<std::pair<uint64_t, uint64_t>> pairs;
+    parlay::sequence<std::pair<uint64_t, uint64_t>> changing;
+    if (trianglesEnabled || coresEnabled) {
+        parlay::sequence<EdgeKey> keys;
+        for (auto &innerTbl: lt) {
+            for (const auto &vector: innerTbl.second.lock_table()) {
+                for (uint64_t edge: vector.second) keys.push_back({vector.first, edge, innerTbl.first});
+            }
+        }
+        changing = changingPairs(insert, std::move(keys));
+    }
+
     for (const auto &innerTbl: lt) {
         Edge edgeData = innerTbl.second;
         auto lt2 = edgeData.lock_table();
+        touchedTimes.push_back(innerTbl.first);
+        touchedSources.emplace_back();
 
         for (const auto &vector: lt2) {
+            if (snapshotsEnabled) touchedSources.back().push_back(vector.first);
             for (auto &edge: vector.second) {
+                if (snapshotsEnabled) touchedSources.back().push_back(edge);
                 if (insert) insertEdgeUndirected(vector.first, edge, innerTbl.first);
                 else deleteEdgeUndirected(vector.first, edge, innerTbl.first);
+                if (componentsEnabled) pairs.emplace_back(vector.first, edge);
             }
         }
     }
+    if (componentsEnabled) updateComponents(insert, pairs);
+    if (trianglesEnabled) updateTriangles(insert, changing);
+    if (coresEnabled) updateCores(insert, changing);
+    rebuildStatsIndex();
+    if (snapshotsEnabled) publishSnapshot(touchedTimes, touchedSources);
     auto t2 = std::chrono::high_resolution_clock::now();
     auto ms_int = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
     std::cout << "batchOperationCuckoo has taken " << ms_int.count() << "ms\n";
@@ -271,27 +528,143 @@ void AdjList::batchOperation(bool insert, NestedMap &groupedData) {
 
 /**
  * Works similar to batchOperation. Iterates in parallel.
+ * Timestamps are split into tasks of consecutive sources, so that a batch whose edges fall into few timestamps still
+ * uses all workers. The task size is derived from the batch size and the number of workers. New timestamps are
+ * created up front in ascending order, afterwards the tasks work directly on the inner maps, so tasks of the same
+ * timestamp do not wait for the lock of its outer bucket.
+ * In deterministic mode every timestamp is one task that applies its sources in ascending order.
  * @param insert dictates whether to insert or delete the given data
  * @param groupedData Nested cuckoo map of edges that are to be inserted/deleted
  * @param uniqueTimesMap helper parameter to iterate through @p groupedData
  */
 void AdjList::batchOperationParlay(bool insert, NestedMap &groupedData, std::unordered_map<uint64_t, uint64_t> uniqueTimesMap) {
     auto t1 = std::chrono::high_resolution_clock::now();
+    std::lock_guard<std::mutex> writer(batchMutex);
     auto lt = groupedData.lock_table();
+    size_t timeCount = uniqueTimesMap.size();
+
+    //sources of every timestamp with their destinations, pointers stay valid as long as groupedData is locked
+    std::vector<uint64_t> times(timeCount);
+    std::vector<std::vector<std::pair<uint64_t, const std::vector<uint64_t>*>>> rows(timeCount);
+    std::vector<uint64_t> edgeCounts(timeCount, 0);
+    parlay::parallel_for(0, timeCount, [&](size_t i) {
+        times[i] = uniqueTimesMap.at(i);
+        auto it = lt.find(times[i]);
+        if (it == lt.end()) return;
+        auto lt2 = it->second.lock_table();
+        for (const auto &vector: lt2) {
+            rows[i].emplace_back(vector.first, &vector.second);
+            edgeCounts[i] += vector.second.size();
+        }
+        if (deterministic) std::sort(rows[i].begin(), rows[i].end());
+    }, 1);
+
+    //new timestamps are created before the tasks start and deletions leave empty timestamps in place until all tasks
+    //are done. Other batches and evictions wait for batchMutex, so the outer table is not modified while the tasks
+    //work on the inner maps without holding its locks. In deterministic mode vertexBitmaps and timestampStats only
+    //gain timestamps in this loop as well, so their layout does not depend on the order of the workers
+    if (insert) {
+        std::vector<uint64_t> sortedTimes(times);
+        std::sort(sortedTimes.begin(), sortedTimes.end());
+        for (uint64_t time: sortedTimes) {
+            edges.insert(time);
+            if (deterministic) {
+                vertexBitmaps.insert(time);
+                timestampStats.insert(time);
+            }
+        }
+    }
+    std::vector<Edge*> partitions(timeCount, nullptr);
+    for (size_t i = 0; i < timeCount; i++) {
+        edges.find_fn(times[i], [&](Edge &e) { partitions[i] = &e; });
+    }
 
-    parlay::parallel_for(0, uniqueTimesMap.size(), [&](uint64_t i) {
-        uint64_t time = uniqueTimesMap[i];
+    //whether an edge changes the graph has to be known before the batch is applied
+    parlay::sequence<std::pair<uint64_t, uint64_t>> changing;
+    if (trianglesEnabled || coresEnabled) {
+        changing = changingPairs(insert, parlay::flatten(parlay::tabulate(timeCount, [&](size_t i) {
+            parlay::sequence<EdgeKey> timeKeys;
+            for (const auto &row: rows[i]) {
+                for (uint64_t destination: *row.second) timeKeys.push_back({row.first, destination, times[i]});
+            }
+            return timeKeys;
+        }, 1)));
+    }
 
-        Edge innerTbl = lt.find(time)->second;
-        auto lt2 = innerTbl.lock_table();
+    //split every timestamp into ranges of sources with about granularity edges each
+    uint64_t totalEdges = 0;
+    for (uint64_t count: edgeCounts) totalEdges += count;
+    uint64_t granularity = std::max<uint64_t>(1024, totalEdges / (8 * parlay::num_workers()));
+    //the reverse directions of a timestamp are spread over all of its sources, splitting it would make their order
+    //depend on the schedule
+    if (deterministic) granularity = std::numeric_limits<uint64_t>::max();
+
+    struct Task { size_t time; size_t begin; size_t end; };
+    std::vector<Task> tasks;
+    for (size_t i = 0; i < timeCount; i++) {
+        size_t begin = 0;
+        uint64_t taskEdges = 0;
+        for (size_t j = 0; j < rows[i].size(); j++) {
+            taskEdges += rows[i][j].second->size();
+            if (taskEdges >= granularity) {
+                tasks.push_back({i, begin, j + 1});
+                begin = j + 1;
+                taskEdges = 0;
+            }
+        }
+        if (begin < rows[i].size()) tasks.push_back({i, begin, rows[i].size()});
+    }
 
-        for (const auto &vector: lt2) {
-            for (auto &edge: vector.second) {
-                if (insert) insertEdgeUndirected(vector.first, edge, time);
-                else deleteEdgeUndirected(vector.first, edge, time);
+    //tasks of the same timestamp only meet on the locks of its inner map, counters and bitmap are updated once per task
+    parlay::parallel_for(0, tasks.size(), [&](size_t k) {
+        const Task &task = tasks[k];
+        Edge *partition = partitions[task.time];
+        if (partition == nullptr) return;
+        PartitionDelta delta;
+
+        for (size_t j = task.begin; j < task.end; j++) {
+            const auto &vector = rows[task.time][j];
+            for (auto &edge: *vector.second) {
+                if (insert) {
+                    if (insertIntoPartition(*partition, vector.first, edge, delta)) {
+                        insertIntoPartition(*partition, edge, vector.first, delta);
+                    }
+                } else if (eraseFromPartition(*partition, vector.first, edge, delta)) {
+                    eraseFromPartition(*partition, edge, vector.first, delta);
+                }
             }
         }
-    });
+        applyDelta(times[task.time], delta);
+    }, 1);
+    if (!insert) {
+        for (size_t i = 0; i < timeCount; i++) {
+            if (partitions[i] != nullptr) eraseIfEmpty(times[i]);
+        }
+    }
+    if (componentsEnabled) {
+        auto pairs = parlay::flatten(parlay::tabulate(timeCount, [&](size_t i) {
+            parlay::sequence<std::pair<uint64_t, uint64_t>> timePairs;
+            for (const auto &row: rows[i]) {
+                for (uint64_t destination: *row.second) timePairs.emplace_back(row.first, destination);
+            }
+            return timePairs;
+        }, 1));
+        updateComponents(insert, pairs);
+    }
+    if (trianglesEnabled) updateTriangles(insert, changing);
+    if (coresEnabled) updateCores(insert, changing);
+    rebuildStatsIndex();
+    if (snapshotsEnabled) {
+        //every edge is applied in both directions, so its destination is a touched source as well
+        std::vector<std::vector<uint64_t>> touchedSources(timeCount);
+        parlay::parallel_for(0, timeCount, [&](size_t i) {
+            for (const auto &row: rows[i]) {
+                touchedSources[i].push_back(row.first);
+                touchedSources[i].insert(touchedSources[i].end(), row.second->begin(), row.second->end());
+            }
+        }, 1);
+        publishSnapshot(times, touchedSources);
+    }
     auto t2 = std::chrono::high_resolution_clock::now();
     auto ms_int = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
     std::cout << "addBatchCuckooParlay has taken " << ms_int.count() << "ms\n";
@@ -352,6 +725,7 @@ void AdjList::printGroupedData(libcuckoo::cuckoohash_map<uint64_t, Edge> &groupe
 
 /**
  * Applies the given function @p func to all edges within the given range.
+ * Every timestamp is copied while it is locked and @p func runs on the copy, so it may query the graph.
  * @param start of the range inclusive
  * @param end of the range exclusive
  * @param func
@@ -361,11 +735,9 @@ void AdjList::rangeQuery(uint64_t start, uint64_t end, const std::function<void(
     auto uniqueTimesMap = genUniqueTimeMap(start, end);
 
     for (auto &time: uniqueTimesMap) {
-        Edge e = edges.find(time.second);
-
-        for (const auto &vector: e.lock_table()) {
-            for (auto &edge: vector.second) {
-                func(time.second, vector.first, edge);
+        for (const auto &row: copyRows(time.second)) {
+            for (uint64_t edge: row.second) {
+                func(time.second, row.first, edge);
             }
         }
     }
@@ -374,40 +746,31 @@ void AdjList::rangeQuery(uint64_t start, uint64_t end, const std::function<void(
     std::cout << "rangeQuery has taken " << ms_int.count() << "ms\n";
 }
 
-
-template <typename F>
-void AdjList::rangeQueryToTimeParlay(uint64_t start, uint64_t end, F&& f) {
-    //auto t1 = std::chrono::high_resolution_clock::now();
-    auto uniqueTimesMap = genUniqueTimeMap(start, end);
-    //auto lt = edges.lock_table();
-
-    parlay::parallel_for(0, uniqueTimesMap.size(), [&](uint64_t i) {
-        uint64_t time = uniqueTimesMap[i];
-        Edge innerTbl = edges.find(time);
-        f(time, innerTbl);
+/**
+ * Copies the rows of one timestamp while it is locked, callbacks run on the copy after the lock is released. Only
+ * rangeQuery needs this, its callback may query or modify the graph. Internal callers use visitRange instead.
+ * @param time
+ * @return every source of @p time with its destinations, empty if the timestamp does not exist
+ */
+PartitionRows AdjList::copyRows(uint64_t time) {
+    PartitionRows rows;
+    edges.find_fn(time, [&](Edge &e) {
+        auto lt = e.lock_table();
+        rows.reserve(lt.size());
+        for (const auto &vector: lt) rows.emplace_back(vector.first, vector.second);
     });
-    /*
-    auto t2 = std::chrono::high_resolution_clock::now();
-    auto ms_int = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
-    std::cout << "rangeQueryToTimeParlay has taken " << ms_int.count() << "ms\n";
-     */
+    return rows;
 }
 
 /**
- * Applies the given function @p func to all inner map entries within the given range.
+ * Applies the given function @p func to all inner map entries within the given range, see visitRange.
  * @param start of the range inclusive
  * @param end of the range exclusive
- * @param func
+ * @param func called with the timestamp, the source and its destinations while the timestamp is locked
  */
 template <typename F>
 void AdjList::rangeQueryToSourceParlay(uint64_t start, uint64_t end, F&& f) {
-    auto innerF = [&f](uint64_t time, Edge edgeMap){
-        auto lt = edgeMap.lock_table();
-        for (auto &edge: lt) {
-            f(time, edge);
-        }
-    };
-    rangeQueryToTimeParlay(start, end, innerF);
+    visitRange(start, end, f);
 }
 
 /**
@@ -418,9 +781,8 @@ void AdjList::rangeQueryToSourceParlay(uint64_t start, uint64_t end, F&& f) {
  */
 template <typename F>
 void AdjList::rangeQueryToDestParlay(uint64_t start, uint64_t end, F&& f) {
-    auto innerF = [&f](uint64_t time, std::pair<uint64_t, std::vector<uint64_t>> v){
-        uint64_t source = v.first;
-        for (uint64_t &destination: v.second) {
+    auto innerF = [&f](uint64_t time, uint64_t source, DestinationSpan destinations){
+        for (uint64_t destination: destinations) {
             f(time, source, destination);
         }
     };
@@ -436,13 +798,44 @@ void AdjList::rangeQueryToDestParlay(uint64_t start, uint64_t end, F&& f) {
 libcuckoo::cuckoohash_map<uint64_t, bool> AdjList::getVertices(uint64_t start, uint64_t end){
     //cuckoomap because it's threadsafe, tried parlay::sequence which was not threadsafe in my tests
     libcuckoo::cuckoohash_map<uint64_t, bool> map;
-    auto f = [&map](uint64_t time, const std::pair<uint64_t, std::vector<uint64_t>>& sourceMap){
-        map.insert(sourceMap.first, false);
-    };
-    rangeQueryToSourceParlay(start, end, f);
+    auto vertices = getVertexBitmap(start, end).toSequence();
+    map.reserve(vertices.size());
+    if (deterministic) {
+        for (uint64_t vertex: vertices) map.insert(vertex, false);
+        return map;
+    }
+    parlay::parallel_for(0, vertices.size(), [&](size_t i) {
+        map.insert(vertices[i], false);
+    });
     return map;
 }
 
+/**
+ * Merges the per timestamp vertex bitmaps of the given range. Every vertex is only inserted once, the merge itself is
+ * a parallel OR over the bitmaps. The bitmaps are only referenced under the table lock, the merge runs unlocked, so
+ * batches are not blocked by it and change copies of the referenced bitmaps meanwhile.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return bitmap of all vertices that have an edge within the time range
+ */
+VertexBitmap AdjList::getVertexBitmap(uint64_t start, uint64_t end){
+    auto uniqueTimesMap = genUniqueTimeMap(start, end);
+    std::vector<std::shared_ptr<const VertexBitmap>> referenced;
+    referenced.reserve(uniqueTimesMap.size());
+    {
+        auto lt = vertexBitmaps.lock_table();
+        for (auto &time: uniqueTimesMap) {
+            auto it = lt.find(time.second);
+            if (it != lt.end() && it->second) referenced.push_back(it->second);
+        }
+    }
+
+    std::vector<const VertexBitmap*> bitmaps;
+    bitmaps.reserve(referenced.size());
+    for (const auto &bitmap: referenced) bitmaps.push_back(bitmap.get());
+    return VertexBitmap::unionAll(bitmaps);
+}
+
 /**
  *
  * @param start of the range inclusive
@@ -452,8 +845,8 @@ libcuckoo::cuckoohash_map<uint64_t, bool> AdjList::getVertices(uint64_t start, u
  */
 Edge AdjList::getNeighboursOld(uint64_t start, uint64_t end, uint64_t source){
     Edge map;
-    auto f = [&map, &source](uint64_t time, const std::pair<uint64_t, std::vector<uint64_t>>& v){
-        if (v.first == source) map.insert(time, v.second);
+    auto f = [&map, &source](uint64_t time, uint64_t vertex, DestinationSpan destinations){
+        if (vertex == source) map.insert(time, std::vector<uint64_t>(destinations.begin(), destinations.end()));
     };
     rangeQueryToSourceParlay(start, end, f);
     return map;
@@ -462,41 +855,94 @@ Edge AdjList::getNeighboursOld(uint64_t start, uint64_t end, uint64_t source){
 
 void AdjList::getNeighboursHelper(uint64_t start, uint64_t end, uint64_t source, libcuckoo::cuckoohash_map<uint64_t, bool> &map){
     std::set<uint64_t> set;
-    auto f = [&](uint64_t time, const Edge& innerTbl){
-        if (innerTbl.contains(source)){
-            std::vector<uint64_t> destinationVector = innerTbl.find(source);
-            for (uint64_t destination : destinationVector) {
-                if (!map.contains(destination)){
-                    set.insert(destination);
-                    map.insert(destination, false);
-                }
+    std::mutex setMutex;
+    //only touches map and set, so it may run while the timestamp is locked
+    auto f = [&](uint64_t, uint64_t vertex, DestinationSpan destinations){
+        if (vertex != source) return;
+        for (uint64_t destination : destinations) {
+            if (map.insert(destination, false)){
+                std::lock_guard<std::mutex> guard(setMutex);
+                set.insert(destination);
             }
         }
     };
-    rangeQueryToTimeParlay(start, end, f);
+    visitRange(start, end, f);
     for (uint64_t nextSource:set) {
         getNeighboursHelper(start, end, nextSource, map);
     }
 }
 
+/**
+ * Prints the memory report of the graph.
+ * @see AdjList::getMemoryReport
+ * @return total bytes of the report
+ */
 uint64_t AdjList::memoryConsumption() {
+    MemoryReport report = getMemoryReport();
+    report.print();
+    return report.total();
+}
 
-    auto lt = edges.lock_table();
-    uint64_t memory=0;
+/**
+ * Measures the allocated memory of every part of the graph. Tables are measured by their bucket count and the
+ * destinations by the capacity kept in the timestamp counters, so the cost is linear in the number of timestamps
+ * and vertex bitmap containers, not in the number of edges.
+ * @return memory per part
+ */
+MemoryReport AdjList::getMemoryReport() {
+    MemoryReport report;
+    report.outerTable = cuckooTableBytes(edges);
+
+    auto times = timesInRange(0, std::numeric_limits<uint64_t>::max());
+    //red black tree node: color, parent, left and right pointer and the key
+    report.timestampIndex = times.size() * (4 * sizeof(void*) + sizeof(uint64_t));
+
+    auto inner = parlay::tabulate(times.size(), [&](size_t i) {
+        uint64_t bytes = 0;
+        edges.find_fn(times[i], [&bytes](Edge &e) { bytes = cuckooTableBytes(e); });
+        return bytes;
+    });
+    report.innerTables = parlay::reduce(inner);
+    auto destinations = parlay::tabulate(times.size(), [&](size_t i) {
+        TimestampStats stats = getStats(times[i]);
+        return stats.bytes - stats.sources * (sizeof(uint64_t) + sizeof(std::vector<uint64_t>));
+    });
+    report.destinations = parlay::reduce(destinations);
 
-    for(auto &it:lt){
-        uint64_t key = it.first;
-        Edge edgeData = it.second;
-        auto lt2 = edgeData.lock_table();
+    report.vertexBitmaps = cuckooTableBytes(vertexBitmaps);
+    {
+        auto lt = vertexBitmaps.lock_table();
+        for (const auto &bitmap: lt) {
+            if (bitmap.second) report.vertexBitmaps += sizeof(VertexBitmap) + bitmap.second->memoryUsage();
+        }
+    }
 
-        for(const auto &vector: lt2){
-            for(auto &edge: vector.second){
-                memory+=sizeof (key) + sizeof (vector.first) + sizeof (edge);
-            }
+    report.statistics = cuckooTableBytes(timestampStats);
+    if (auto index = std::atomic_load(&statsIndex)) {
+        report.statistics += sizeof(StatsIndex) + index->times.capacity() * sizeof(uint64_t) +
+                             index->prefix.capacity() * sizeof(TimestampStats);
+    }
+
+    if (auto snapshot = std::atomic_load(&published)) {
+        for (const auto &partition: snapshot->partitions) {
+            const SnapshotPartition &p = *partition.second;
+            report.snapshot += sizeof(SnapshotPartition) + p.sources.capacity() * sizeof(uint64_t) +
+                               p.rows.capacity() * sizeof(std::shared_ptr<const std::vector<uint64_t>>);
+            for (const auto &row: p.rows) report.snapshot += sizeof(std::vector<uint64_t>) + row->capacity() * sizeof(uint64_t);
         }
     }
-    std::cout << "Memory consumption in Bytes:" << memory << std::endl;
-    return memory;
+    return report;
+}
+
+/**
+ * @param timestamp
+ * @return bytes of the source table and the destination vectors of @p timestamp, 0 if it is not in the graph
+ */
+uint64_t AdjList::getTimestampMemory(uint64_t timestamp) {
+    uint64_t bytes = 0;
+    edges.find_fn(timestamp, [&bytes](Edge &e) { bytes = cuckooTableBytes(e); });
+    TimestampStats stats = getStats(timestamp);
+    return bytes + stats.bytes - stats.sources * (sizeof(uint64_t) + sizeof(std::vector<uint64_t>));
 }
 
 /**
@@ -507,53 +953,740 @@ uint64_t AdjList::memoryConsumption() {
  */
 std::map<uint64_t, uint64_t> AdjList::genUniqueTimeMap(uint64_t start, uint64_t end) {
     std::map<uint64_t, uint64_t> map;
+    std::lock_guard<std::mutex> guard(timestampsMutex);
     int i = 0;
-    for (uint64_t time : uniqueTimestamps) {
-        if (start <= time && time < end){
-            map[i] = time;
-            i++;
-        }
+    for (auto it = uniqueTimestamps.lower_bound(start); it != uniqueTimestamps.end() && *it < end; ++it) {
+        map[i] = *it;
+        i++;
     }
     return map;
 }
 
-Edge AdjList::computeComponents(uint64_t start, uint64_t end){
-    auto t1 = std::chrono::high_resolution_clock::now();
+/**
+ * Same as genUniqueTimeMap, but returns the timestamps as a plain vector so they can be indexed from parallel loops.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return sorted timestamps within the range
+ */
+std::vector<uint64_t> AdjList::timesInRange(uint64_t start, uint64_t end) {
+    std::vector<uint64_t> times;
+    std::lock_guard<std::mutex> guard(timestampsMutex);
+    for (auto it = uniqueTimestamps.lower_bound(start); it != uniqueTimestamps.end() && *it < end; ++it) {
+        times.push_back(*it);
+    }
+    return times;
+}
 
-    libcuckoo::cuckoohash_map<uint64_t, bool> allNodes = getVertices(start, end);
-    libcuckoo::cuckoohash_map<uint64_t, bool> map;
+/**
+ * Writes all edges of the given range in (time, source, destination) order. Timestamps are frozen into sorted
+ * partitions in groups of one per worker, while one group is written the next one is already being sorted, so at
+ * most two groups are held in memory.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @param path output file
+ * @param format
+ * @return number of written edges, 0 if the file could not be opened or written
+ */
+uint64_t AdjList::exportRange(uint64_t start, uint64_t end, const std::string &path, ExportFormat format) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    EdgeWriter writer(path, format);
+    if (!writer.isOpen()) return 0;
+
+    auto times = timesInRange(start, end);
+    size_t groupSize = parlay::num_workers();
+    auto freezeGroup = [&](size_t first) {
+        size_t n = std::min(groupSize, times.size() - first);
+        return parlay::tabulate(n, [&](size_t i) { return freezePartition(times[first + i]); }, 1);
+    };
 
-    Edge components;
-    uint64_t cKey = 0;
+    parlay::sequence<std::shared_ptr<const FrozenPartition>> current;
+    if (!times.empty()) current = freezeGroup(0);
+    for (size_t first = 0; first < times.size(); first += groupSize) {
+        parlay::sequence<std::shared_ptr<const FrozenPartition>> next;
+        parlay::par_do([&]() {
+            for (const auto &partition: current) {
+                if (partition) writer.writePartition(*partition);
+            }
+        }, [&]() {
+            if (first + groupSize < times.size()) next = freezeGroup(first + groupSize);
+        });
+        current = std::move(next);
+    }
+    if (!writer.flush()) return 0;
 
-    auto lt = allNodes.lock_table();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto ms_int = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+    std::cout << "exportRange has taken " << ms_int.count() << "ms\n";
+    return writer.getCount();
+}
 
-    for (auto sources: lt) {
-        uint64_t source = sources.first;
+/**
+ * Finds the first timestamp in the graph that is not older than @p from, without copying the range.
+ * @param from
+ * @param end upper bound exclusive
+ * @param time receives the found timestamp
+ * @return false if there is no timestamp in [from, end)
+ */
+bool AdjList::nextTimestamp(uint64_t from, uint64_t end, uint64_t &time) {
+    std::lock_guard<std::mutex> guard(timestampsMutex);
+    auto it = uniqueTimestamps.lower_bound(from);
+    if (it == uniqueTimestamps.end() || *it >= end) return false;
+    time = *it;
+    return true;
+}
 
-        if (!map.contains(source)){
-            map.insert(source, false);
+/**
+ * Sets how many of the most recent time units are kept. After every inserted batch, all timestamps older than
+ * the newest inserted timestamp minus @p window are evicted.
+ * @param window number of time units to keep, 0 disables the retention policy
+ */
+void AdjList::setRetentionWindow(uint64_t window) {
+    retentionWindow = window;
+}
 
-            getNeighboursHelper(start, end, source, map);
-            libcuckoo::cuckoohash_map<uint64_t, bool>  tempMap = map;
+/**
+ * Drops all timestamps older than @p horizon as whole partitions, individual edges are not touched.
+ * The timestamps are first unlinked from uniqueTimestamps so that range queries never see a partially evicted
+ * range, afterwards the inner maps are destroyed. The outer tables are only shrunk once they became sparse.
+ * @param horizon oldest timestamp that is kept
+ * @return number of evicted timestamps
+ */
+size_t AdjList::evictBefore(uint64_t horizon) {
+    std::lock_guard<std::mutex> writer(batchMutex);
+    std::set<uint64_t> expired;
+    {
+        std::lock_guard<std::mutex> guard(timestampsMutex);
+        auto last = uniqueTimestamps.lower_bound(horizon);
+        if (last == uniqueTimestamps.begin()) return 0;
+        while (uniqueTimestamps.begin() != last) {
+            expired.insert(expired.end(), uniqueTimestamps.extract(uniqueTimestamps.begin()));
+        }
+    }
 
-            components.insert(cKey, std::vector<uint64_t>{});
+    if (componentsEnabled || trianglesEnabled || coresEnabled) {
+        auto pairs = collectPairs(std::vector<uint64_t>(expired.begin(), expired.end()), [](uint64_t) { return true; });
+        if (componentsEnabled) updateComponents(false, pairs);
+        if (trianglesEnabled) updateTriangles(false, pairs);
+        if (coresEnabled) updateCores(false, pairs);
+    }
+    for (uint64_t time: expired) {
+        edges.erase(time);
+        vertexBitmaps.erase(time);
+        timestampStats.erase(time);
+    }
+    shrinkIfSparse(edges);
+    shrinkIfSparse(vertexBitmaps);
+    shrinkIfSparse(timestampStats);
+    rebuildStatsIndex();
+    if (snapshotsEnabled) {
+        publishSnapshot(std::vector<uint64_t>(expired.begin(), expired.end()),
+                        std::vector<std::vector<uint64_t>>(expired.size()));
+    }
+    return expired.size();
+}
 
-            auto lt2 = tempMap.lock_table();
-            for (auto &connectedNodes:lt2) {
-                uint64_t connectedNode = connectedNodes.first;
-                if (!map.find(connectedNode)) {
-                    map.update(connectedNode, true);
-                    components.update_fn(cKey, [&connectedNode](std::vector<uint64_t> &vector) { vector.push_back(connectedNode); });
+/**
+ * Collects the edges of the given timestamps as (smaller, larger) vertex pairs, one task per timestamp.
+ * @param times timestamps to be read
+ * @param keep called with the smaller vertex, only pairs for which it returns true are collected
+ * @return pairs in no particular order, an edge appears once per timestamp that contains it
+ */
+template<typename Keep>
+parlay::sequence<std::pair<uint64_t, uint64_t>> AdjList::collectPairs(const std::vector<uint64_t> &times, Keep &&keep) {
+    auto perTime = parlay::tabulate(times.size(), [&](size_t i) {
+        parlay::sequence<std::pair<uint64_t, uint64_t>> pairs;
+        edges.find_fn(times[i], [&](Edge &e) {
+            auto lt = e.lock_table();
+            for (const auto &vector: lt) {
+                if (!keep(vector.first)) continue;
+                for (uint64_t destination: vector.second) {
+                    if (vector.first <= destination) pairs.emplace_back(vector.first, destination);
                 }
             }
-            cKey++;
+        });
+        return pairs;
+    }, 1);
+    return parlay::flatten(std::move(perTime));
+}
 
-            /*
-            components.insert(cKey, std::vector<uint64_t>{v.first});
-            computeComponentsHelper(start, end, allNodes, v.first, components, cKey);
-             */
+/**
+ * Collects every undirected edge of the given range once, as (smaller, larger) vertex pair, regardless of how many
+ * timestamps contain it.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return sorted pairs without duplicates
+ */
+parlay::sequence<std::pair<uint64_t, uint64_t>> AdjList::windowPairs(uint64_t start, uint64_t end) {
+    auto pairs = collectPairs(timesInRange(start, end), [](uint64_t) { return true; });
+    parlay::sort_inplace(pairs);
+    return parlay::unique(pairs);
+}
+
+/**
+ * Compares the edges of two windows, ignoring their timestamps. Both windows are collected into sorted pair lists,
+ * afterwards every pair of one list is looked up in the other one in parallel. The results are streamed to the
+ * callbacks on the calling thread in ascending order, with the smaller vertex first.
+ * @param oldStart of the old window inclusive
+ * @param oldEnd of the old window exclusive
+ * @param newStart of the new window inclusive
+ * @param newEnd of the new window exclusive
+ * @param added called for every edge that is only in the new window
+ * @param removed called for every edge that is only in the old window
+ */
+void AdjList::diffWindows(uint64_t oldStart, uint64_t oldEnd, uint64_t newStart, uint64_t newEnd,
+                          const std::function<void(uint64_t, uint64_t)> &added,
+                          const std::function<void(uint64_t, uint64_t)> &removed) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    parlay::sequence<std::pair<uint64_t, uint64_t>> oldPairs, newPairs;
+    parlay::par_do([&]() { oldPairs = windowPairs(oldStart, oldEnd); },
+                   [&]() { newPairs = windowPairs(newStart, newEnd); });
+
+    auto difference = [](const auto &from, const auto &other) {
+        return parlay::filter(from, [&other](const std::pair<uint64_t, uint64_t> &pair) {
+            return !std::binary_search(other.begin(), other.end(), pair);
+        });
+    };
+    parlay::sequence<std::pair<uint64_t, uint64_t>> addedPairs, removedPairs;
+    parlay::par_do([&]() { addedPairs = difference(newPairs, oldPairs); },
+                   [&]() { removedPairs = difference(oldPairs, newPairs); });
+
+    for (const auto &pair: addedPairs) added(pair.first, pair.second);
+    for (const auto &pair: removedPairs) removed(pair.first, pair.second);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto ms_int = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+    std::cout << "diffWindows has taken " << ms_int.count() << "ms\n";
+}
+
+/**
+ * Computes the connected components of all edges within the given range. The vertices of the range are numbered
+ * densely in ascending order, afterwards every edge is streamed once through visitRange into a concurrent union find.
+ * The work is linear in the number of edges apart from the binary searches that map vertices to their index.
+ * Components are numbered in the order of their smallest vertex, so the result does not depend on the schedule.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return component of every vertex that has an edge within the range
+ */
+ComponentLabels AdjList::connectedComponents(uint64_t start, uint64_t end) {
+    ComponentLabels labels;
+    labels.vertices = getVertexBitmap(start, end).toSequence();
+    size_t n = labels.vertices.size();
+    ConcurrentUnionFind unionFind(n);
+
+    visitRange(start, end, [&](uint64_t, uint64_t source, DestinationSpan destinations) {
+        uint64_t sourceIndex = labels.indexOf(source);
+        for (uint64_t destination: destinations) {
+            //every edge is stored in both directions, one of them is enough
+            if (destination < source) unionFind.unite(sourceIndex, labels.indexOf(destination));
         }
+    });
+
+    auto roots = parlay::tabulate(n, [&](size_t i) { return unionFind.find(i); });
+    //roots are the smallest index of their component, numbering them in order gives dense ids
+    auto rootIds = parlay::tabulate(n, [&](size_t i) -> uint64_t { return roots[i] == i; });
+    labels.count = parlay::scan_inplace(rootIds);
+    labels.components = parlay::tabulate(n, [&](size_t i) { return rootIds[roots[i]]; });
+    return labels;
+}
+
+/**
+ * Copies the simple undirected graph of the given range into a CSR WindowGraph, for traversals that visit the same
+ * vertices many times. Every edge appears once, regardless of how many timestamps within the range contain it.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return graph of all edges within the range
+ */
+WindowGraph AdjList::getWindowGraph(uint64_t start, uint64_t end) {
+    return WindowGraph(getVertexBitmap(start, end).toSequence(), windowPairs(start, end));
+}
+
+/**
+ * PageRank of the simple undirected graph of the given range, started from the restart distribution. Sliding
+ * windows should use WindowedPageRank, which starts from the ranks of the previous window.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @param options damping, convergence and optional restart vertices
+ * @return ranks of all vertices that have an edge within the range
+ */
+PageRankResult AdjList::pageRank(uint64_t start, uint64_t end, const PageRankOptions &options) {
+    return computePageRank(getWindowGraph(start, end), options);
+}
+
+/**
+ * Counts the triangles of the simple undirected graph of the given range, an edge that exists at several timestamps
+ * is only counted once.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return global and per vertex triangle counts and clustering coefficients
+ */
+TriangleCounts AdjList::countTriangles(uint64_t start, uint64_t end) {
+    return ::countTriangles(getWindowGraph(start, end));
+}
+
+/**
+ * Computes the core numbers of the simple undirected graph of the given range with parallel peeling.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return core numbers of all vertices that have an edge within the range and the degeneracy
+ */
+CoreNumbers AdjList::coreDecomposition(uint64_t start, uint64_t end) {
+    return computeCores(getWindowGraph(start, end));
+}
+
+/**
+ * Counts the δ-temporal motifs of the given range. The edges are read once per timestamp, one task per timestamp,
+ * and handed to the motif engine as events.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @param delta largest difference between the timestamps of the edges of one motif
+ * @return number of motifs per type
+ */
+TemporalMotifCounts AdjList::countTemporalMotifs(uint64_t start, uint64_t end, uint64_t delta) {
+    auto times = timesInRange(start, end);
+    auto perTime = parlay::tabulate(times.size(), [&](size_t i) {
+        parlay::sequence<TemporalEvent> events;
+        edges.find_fn(times[i], [&](Edge &e) {
+            auto lt = e.lock_table();
+            for (const auto &vector: lt) {
+                for (uint64_t destination: vector.second) {
+                    if (destination != vector.first) events.push_back({vector.first, times[i], destination});
+                }
+            }
+        });
+        return events;
+    }, 1);
+    return ::countTemporalMotifs(parlay::flatten(perTime), delta);
+}
+
+/**
+ * Enables or disables maintaining the components of the whole graph during batches. Enabling computes them once
+ * from all edges, afterwards insertions are merged into them and deletions and evictions mark the components they
+ * touch, which are recomputed on their next query.
+ * @param enabled
+ */
+void AdjList::setIncrementalComponents(bool enabled) {
+    std::lock_guard<std::mutex> guard(componentsMutex);
+    componentsEnabled = enabled;
+    incrementalComponents.clear();
+    if (enabled) {
+        incrementalComponents.addEdges(collectPairs(timesInRange(0, std::numeric_limits<uint64_t>::max()),
+                                                    [](uint64_t) { return true; }));
+    }
+}
+
+/**
+ * Called after a batch was applied.
+ * @param insert whether the batch inserted or deleted @p pairs
+ * @param pairs edges of the batch
+ */
+void AdjList::updateComponents(bool insert, const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    std::lock_guard<std::mutex> guard(componentsMutex);
+    if (insert) incrementalComponents.addEdges(pairs);
+    else incrementalComponents.markDirty(pairs);
+}
+
+/**
+ * Recomputes the dirty components from the edges between their vertices. Only those vertices are reset and united
+ * again, but every timestamp is read once to find their edges. The caller holds componentsMutex.
+ */
+void AdjList::refreshComponents() {
+    if (!incrementalComponents.resetDirty()) return;
+    auto pairs = collectPairs(timesInRange(0, std::numeric_limits<uint64_t>::max()), [&](uint64_t source) {
+        return incrementalComponents.wasReset(source);
+    });
+    incrementalComponents.addEdges(pairs);
+}
+
+/**
+ * @param vertex
+ * @return a vertex that represents the component of @p vertex in the whole graph, max uint64 if @p vertex never had
+ * an edge or incremental components are disabled
+ */
+uint64_t AdjList::getComponentId(uint64_t vertex) {
+    std::lock_guard<std::mutex> guard(componentsMutex);
+    if (!componentsEnabled) return std::numeric_limits<uint64_t>::max();
+    refreshComponents();
+    return incrementalComponents.componentOf(vertex);
+}
+
+/**
+ * @param vertex
+ * @return number of vertices in the component of @p vertex in the whole graph, 0 if it is unknown
+ */
+uint64_t AdjList::getComponentSize(uint64_t vertex) {
+    std::lock_guard<std::mutex> guard(componentsMutex);
+    if (!componentsEnabled) return 0;
+    refreshComponents();
+    return incrementalComponents.sizeOf(vertex);
+}
+
+/**
+ * @return number of components in the whole graph, vertices that lost all their edges count as singletons
+ */
+uint64_t AdjList::getComponentCount() {
+    std::lock_guard<std::mutex> guard(componentsMutex);
+    if (!componentsEnabled) return 0;
+    refreshComponents();
+    return incrementalComponents.count();
+}
+
+/**
+ * Freezes the given timestamps one after another, in the order of @p times, and calls @p f(partition, rows, columns)
+ * for each. rows[j] is the position of partition.sources[j] and columns[k] the one of partition.destinations[k] in
+ * @p vertices. No lock is held while @p f runs, so it may use parallel loops over the partition.
+ * @param times timestamps to visit
+ * @param vertices sorted vertices that contain every vertex of the visited timestamps
+ * @param f
+ */
+template<typename F>
+void AdjList::sweepPartitions(const std::vector<uint64_t> &times, const parlay::sequence<uint64_t> &vertices, F &&f) {
+    auto indexOf = [&](uint64_t vertex) -> uint64_t {
+        return std::lower_bound(vertices.begin(), vertices.end(), vertex) - vertices.begin();
+    };
+    for (uint64_t time: times) {
+        auto partition = freezePartition(time);
+        if (!partition) continue;
+        auto rows = parlay::map(partition->sources, indexOf);
+        auto columns = parlay::map(partition->destinations, indexOf);
+        f(*partition, rows, columns);
+    }
+}
+
+/**
+ * Earliest arrival at every vertex on a time respecting path that leaves @p source at @p start or later. An edge of
+ * timestamp t can be taken once its endpoint is reached at t or earlier and arrives at t + 1, so every hop of a path
+ * has a larger timestamp than the one before.
+ * The timestamps are swept once in ascending order. A hop of the current timestamp can not be continued within it,
+ * so all of its edges are relaxed in parallel against the arrivals of the timestamps before.
+ * @param source vertex the paths start at, its own arrival is @p start
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return arrival at every vertex that has an edge within the range
+ */
+TemporalLabels AdjList::earliestArrival(uint64_t source, uint64_t start, uint64_t end) {
+    TemporalLabels labels;
+    labels.vertices = getVertexBitmap(start, end).toSequence();
+    size_t n = labels.vertices.size();
+    constexpr uint64_t unreached = std::numeric_limits<uint64_t>::max();
+    std::vector<std::atomic<uint64_t>> arrival(n);
+    parlay::parallel_for(0, n, [&](size_t i) { arrival[i].store(unreached, std::memory_order_relaxed); });
+
+    uint64_t sourceIndex = labels.indexOf(source);
+    if (sourceIndex != unreached) {
+        arrival[sourceIndex] = start;
+        sweepPartitions(timesInRange(start, end), labels.vertices,
+                        [&](const FrozenPartition &p, const auto &rows, const auto &columns) {
+            auto reached = parlay::tabulate(rows.size(), [&](size_t j) { return arrival[rows[j]].load() <= p.time; });
+            parlay::parallel_for(0, rows.size(), [&](size_t j) {
+                if (!reached[j]) return;
+                for (uint64_t k = p.offsets[j]; k < p.offsets[j + 1]; k++) {
+                    parlay::write_min(&arrival[columns[k]], p.time + 1, std::less<>());
+                }
+            });
+        });
+    }
+    labels.values = parlay::tabulate(n, [&](size_t i) { return arrival[i].load(); });
+    return labels;
+}
+
+/**
+ * Latest departure from every vertex on a time respecting path that reaches @p target by @p end, the reverse of
+ * earliestArrival. The timestamps are swept once in descending order, every source of a timestamp only updates its
+ * own departure, so the sources are processed in parallel.
+ * @param target vertex the paths end at, its own departure is @p end
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return departure of every vertex that has an edge within the range
+ */
+TemporalLabels AdjList::latestDeparture(uint64_t target, uint64_t start, uint64_t end) {
+    TemporalLabels labels;
+    labels.vertices = getVertexBitmap(start, end).toSequence();
+    size_t n = labels.vertices.size();
+    //departure + 1, 0 while the target can not be reached from the vertex
+    std::vector<std::atomic<uint64_t>> departure(n);
+    parlay::parallel_for(0, n, [&](size_t i) { departure[i].store(0, std::memory_order_relaxed); });
+
+    uint64_t targetIndex = labels.indexOf(target);
+    if (targetIndex != std::numeric_limits<uint64_t>::max()) {
+        departure[targetIndex] = end + 1;
+        auto times = timesInRange(start, end);
+        std::reverse(times.begin(), times.end());
+        sweepPartitions(times, labels.vertices, [&](const FrozenPartition &p, const auto &rows, const auto &columns) {
+            parlay::parallel_for(0, rows.size(), [&](size_t j) {
+                //departures written in this timestamp are p.time + 1 and never satisfy the condition
+                for (uint64_t k = p.offsets[j]; k < p.offsets[j + 1]; k++) {
+                    if (departure[columns[k]].load() >= p.time + 2) {
+                        parlay::write_max(&departure[rows[j]], p.time + 1, std::less<>());
+                        break;
+                    }
+                }
+            });
+        });
+    }
+    labels.values = parlay::tabulate(n, [&](size_t i) -> uint64_t {
+        uint64_t value = departure[i].load();
+        return value == 0 ? std::numeric_limits<uint64_t>::max() : value - 1;
+    });
+    return labels;
+}
+
+/**
+ * Duration of the fastest time respecting path from @p source to every vertex, which is its arrival minus the time
+ * it leaves @p source. Every vertex keeps the latest start among the paths that reached it so far, the edges of a
+ * timestamp extend those of the timestamps before, so one ascending sweep is enough.
+ * @param source vertex the paths start at, its own duration is 0
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return duration for every vertex that has an edge within the range
+ */
+TemporalLabels AdjList::fastestPaths(uint64_t source, uint64_t start, uint64_t end) {
+    TemporalLabels labels;
+    labels.vertices = getVertexBitmap(start, end).toSequence();
+    size_t n = labels.vertices.size();
+    constexpr uint64_t unreached = std::numeric_limits<uint64_t>::max();
+    //latest start + 1, 0 while the vertex is not reached
+    std::vector<std::atomic<uint64_t>> latestStart(n);
+    std::vector<std::atomic<uint64_t>> duration(n);
+    parlay::parallel_for(0, n, [&](size_t i) {
+        latestStart[i].store(0, std::memory_order_relaxed);
+        duration[i].store(unreached, std::memory_order_relaxed);
+    });
+
+    uint64_t sourceIndex = labels.indexOf(source);
+    if (sourceIndex != unreached) {
+        duration[sourceIndex] = 0;
+        sweepPartitions(timesInRange(start, end), labels.vertices,
+                        [&](const FrozenPartition &p, const auto &rows, const auto &columns) {
+            //starts are read before any of this timestamp is written, hops of it can not be continued within it
+            auto starts = parlay::tabulate(rows.size(), [&](size_t j) -> uint64_t {
+                return rows[j] == sourceIndex ? p.time + 1 : latestStart[rows[j]].load();
+            });
+            parlay::parallel_for(0, rows.size(), [&](size_t j) {
+                if (starts[j] == 0) return;
+                for (uint64_t k = p.offsets[j]; k < p.offsets[j + 1]; k++) {
+                    if (columns[k] == sourceIndex) continue;
+                    parlay::write_max(&latestStart[columns[k]], starts[j], std::less<>());
+                    parlay::write_min(&duration[columns[k]], p.time + 2 - starts[j], std::less<>());
+                }
+            });
+        });
+    }
+    labels.values = parlay::tabulate(n, [&](size_t i) { return duration[i].load(); });
+    return labels;
+}
+
+/**
+ * @param source vertex the paths start at
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return sorted vertices reachable from @p source on time respecting paths, including itself if it has an edge
+ * within the range
+ */
+parlay::sequence<uint64_t> AdjList::temporalReachable(uint64_t source, uint64_t start, uint64_t end) {
+    return earliestArrivals({source}, start, end).reachable(0);
+}
+
+/**
+ * earliestArrival for several sources in one sweep. Every vertex keeps a bitmask of the sources that reached it, an
+ * edge passes the mask of its endpoint from before the timestamp on with one bitwise or per 64 sources, and the edge
+ * that sets a bit records the arrival of that source. The sweep touches every edge once per 64 sources.
+ * @param sources vertices the paths start at
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return arrival of every source at every vertex that has an edge within the range
+ */
+MultiSourceArrivals AdjList::earliestArrivals(const std::vector<uint64_t> &sources, uint64_t start, uint64_t end) {
+    MultiSourceArrivals result;
+    result.sources = sources;
+    result.vertices = getVertexBitmap(start, end).toSequence();
+    size_t n = result.vertices.size();
+    size_t words = (sources.size() + 63) / 64;
+    std::vector<std::atomic<uint64_t>> masks(n * words);
+    parlay::parallel_for(0, n * words, [&](size_t i) { masks[i].store(0, std::memory_order_relaxed); });
+    result.arrivals = parlay::sequence<uint64_t>(sources.size() * n, std::numeric_limits<uint64_t>::max());
+
+    bool anySource = false;
+    for (size_t i = 0; i < sources.size(); i++) {
+        auto it = std::lower_bound(result.vertices.begin(), result.vertices.end(), sources[i]);
+        if (it == result.vertices.end() || *it != sources[i]) continue;
+        size_t index = it - result.vertices.begin();
+        masks[index * words + i / 64] |= uint64_t(1) << (i % 64);
+        result.arrivals[i * n + index] = start;
+        anySource = true;
+    }
+    if (!anySource) return result;
+
+    sweepPartitions(timesInRange(start, end), result.vertices,
+                    [&](const FrozenPartition &p, const auto &rows, const auto &columns) {
+        auto staged = parlay::tabulate(rows.size() * words, [&](size_t i) {
+            return masks[rows[i / words] * words + i % words].load();
+        });
+        parlay::parallel_for(0, rows.size(), [&](size_t j) {
+            for (uint64_t k = p.offsets[j]; k < p.offsets[j + 1]; k++) {
+                uint64_t column = columns[k];
+                for (size_t w = 0; w < words; w++) {
+                    std::atomic<uint64_t> &mask = masks[column * words + w];
+                    uint64_t fresh = staged[j * words + w] & ~mask.load(std::memory_order_relaxed);
+                    if (fresh == 0) continue;
+                    //only the edge that sets a bit records the arrival of its source
+                    fresh &= ~mask.fetch_or(fresh);
+                    while (fresh != 0) {
+                        size_t sourceIndex = w * 64 + __builtin_ctzll(fresh);
+                        result.arrivals[sourceIndex * n + column] = p.time + 1;
+                        fresh &= fresh - 1;
+                    }
+                }
+            }
+        });
+    });
+    return result;
+}
+
+/**
+ * Enables or disables maintaining the triangles of the whole graph during batches. The graph is treated as simple,
+ * an edge that exists at several timestamps is one edge until it is removed from the last of them. Enabling counts
+ * the triangles of all edges once, afterwards every batch and eviction only intersects the neighbourhoods of the
+ * edges it changed.
+ * @param enabled
+ */
+void AdjList::setIncrementalTriangles(bool enabled) {
+    std::lock_guard<std::mutex> guard(trianglesMutex);
+    trianglesEnabled = enabled;
+    incrementalTriangles.clear();
+    if (enabled) {
+        incrementalTriangles.addOccurrences(collectPairs(timesInRange(0, std::numeric_limits<uint64_t>::max()),
+                                                         [](uint64_t) { return true; }));
+    }
+}
+
+/**
+ * Reduces the edges of a batch to the ones that change the graph, it has to be called before the batch is applied.
+ * Both directions and repetitions of an edge within a timestamp count once, self loops are dropped.
+ * @param insert whether the batch inserts or deletes @p keys
+ * @param keys edges of the batch
+ * @return (smaller, larger) pair for every timestamp that gains or loses the edge
+ */
+parlay::sequence<std::pair<uint64_t, uint64_t>> AdjList::changingPairs(bool insert, parlay::sequence<EdgeKey> keys) {
+    auto canonical = parlay::map(parlay::filter(keys, [](const EdgeKey &key) {
+        return key.source != key.destination;
+    }), [](const EdgeKey &key) {
+        return EdgeKey{std::min(key.source, key.destination), std::max(key.source, key.destination), key.time};
+    });
+    auto less = [](const EdgeKey &a, const EdgeKey &b) {
+        return std::tie(a.source, a.destination, a.time) < std::tie(b.source, b.destination, b.time);
+    };
+    parlay::sort_inplace(canonical, less);
+    auto distinct = parlay::unique(canonical, [](const EdgeKey &a, const EdgeKey &b) {
+        return a.source == b.source && a.destination == b.destination && a.time == b.time;
+    });
+    auto found = findEdges(std::vector<EdgeKey>(distinct.begin(), distinct.end()));
+    auto changing = parlay::pack_index(parlay::tabulate(distinct.size(), [&](size_t i) { return found[i] != insert; }));
+    return parlay::map(changing, [&](size_t i) { return std::make_pair(distinct[i].source, distinct[i].destination); });
+}
+
+/**
+ * Called after a batch or an eviction was applied.
+ * @param insert whether the timestamps gained or lost @p pairs
+ * @param pairs edges that changed, once per timestamp
+ */
+void AdjList::updateTriangles(bool insert, const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    std::lock_guard<std::mutex> guard(trianglesMutex);
+    if (insert) incrementalTriangles.addOccurrences(pairs);
+    else incrementalTriangles.removeOccurrences(pairs);
+}
+
+/**
+ * @return number of triangles in the whole graph, 0 if incremental triangles are disabled
+ */
+uint64_t AdjList::getTriangleCount() {
+    std::lock_guard<std::mutex> guard(trianglesMutex);
+    return incrementalTriangles.count();
+}
+
+/**
+ * @param vertex
+ * @return number of triangles @p vertex is part of in the whole graph, 0 if incremental triangles are disabled
+ */
+uint64_t AdjList::getVertexTriangles(uint64_t vertex) {
+    std::lock_guard<std::mutex> guard(trianglesMutex);
+    return incrementalTriangles.trianglesOf(vertex);
+}
+
+/**
+ * Enables or disables maintaining the core numbers of the whole graph during batches, with the same simple graph as
+ * the incremental triangles. Enabling inserts all edges once, afterwards every edge that a batch or an eviction adds
+ * to or removes from the simple graph only revisits the vertices whose core number it can change.
+ * @param enabled
+ */
+void AdjList::setIncrementalCores(bool enabled) {
+    std::lock_guard<std::mutex> guard(coresMutex);
+    coresEnabled = enabled;
+    incrementalCores.clear();
+    if (enabled) {
+        incrementalCores.addOccurrences(collectPairs(timesInRange(0, std::numeric_limits<uint64_t>::max()),
+                                                     [](uint64_t) { return true; }));
+    }
+}
+
+/**
+ * Called after a batch or an eviction was applied.
+ * @param insert whether the timestamps gained or lost @p pairs
+ * @param pairs edges that changed, once per timestamp
+ */
+void AdjList::updateCores(bool insert, const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    std::lock_guard<std::mutex> guard(coresMutex);
+    if (insert) incrementalCores.addOccurrences(pairs);
+    else incrementalCores.removeOccurrences(pairs);
+}
+
+/**
+ * @param vertex
+ * @return core number of @p vertex in the whole graph, 0 if incremental cores are disabled
+ */
+uint64_t AdjList::getCoreNumber(uint64_t vertex) {
+    std::lock_guard<std::mutex> guard(coresMutex);
+    return incrementalCores.coreOf(vertex);
+}
+
+/**
+ * @return largest core number of the whole graph, 0 if incremental cores are disabled
+ */
+uint64_t AdjList::getDegeneracy() {
+    std::lock_guard<std::mutex> guard(coresMutex);
+    return incrementalCores.degeneracy();
+}
+
+/**
+ * Groups the result of connectedComponents into one vector per component.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return Cuckoomap with key = component, value = sorted vertices of the component
+ */
+Edge AdjList::computeComponents(uint64_t start, uint64_t end){
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    ComponentLabels labels = connectedComponents(start, end);
+    size_t n = labels.vertices.size();
+    auto members = parlay::tabulate(n, [&](size_t i) {
+        return std::make_pair(labels.components[i], labels.vertices[i]);
+    });
+    parlay::sort_inplace(members);
+    auto firsts = parlay::pack_index(parlay::tabulate(n, [&](size_t i) {
+        return i == 0 || members[i].first != members[i - 1].first;
+    }));
+
+    Edge components;
+    components.reserve(labels.count);
+    auto insertComponent = [&](size_t c) {
+        size_t first = firsts[c];
+        size_t last = c + 1 < firsts.size() ? firsts[c + 1] : n;
+        std::vector<uint64_t> vertices(last - first);
+        for (size_t i = first; i < last; i++) vertices[i - first] = members[i].second;
+        components.insert(c, std::move(vertices));
+    };
+    if (deterministic) {
+        for (size_t c = 0; c < firsts.size(); c++) insertComponent(c);
+    } else {
+        parlay::parallel_for(0, firsts.size(), insertComponent);
     }
 
     auto t2 = std::chrono::high_resolution_clock::now();
@@ -602,36 +1735,247 @@ size_t AdjList::getSize() {
     return edges.size();
 }
 
+/**
+ * @param timestamp
+ * @return number of directed edges at @p timestamp, read from its counters
+ */
 uint64_t AdjList::getEdgeCount(uint64_t timestamp){
-    uint64_t count = 0;
-    edges.find_fn(timestamp,[&count](Edge &e){
-      auto lt = e.lock_table();
-        for (const auto &vector: lt) {
-            for (auto &edge: vector.second) {
-                count++;
-            }
-        }
-    });
-    return count;
+    return getStats(timestamp).edges;
 }
 
+/**
+ * @param timestamp
+ * @return number of sources at @p timestamp, read from its counters
+ */
 uint64_t AdjList::getInnerTblCount(uint64_t timestamp){
-    uint64_t count = 0;
-    edges.find_fn(timestamp,[&count](Edge &e){
-        auto lt = e.lock_table();
-        for (const auto &vector: lt) {
-                count++;
-        }
-    });
-    return count;
+    return getStats(timestamp).sources;
+}
+
+/**
+ * @param timestamp
+ * @return current counters of @p timestamp, all zero if it is not in the graph
+ */
+TimestampStats AdjList::getStats(uint64_t timestamp) {
+    TimestampStats stats;
+    timestampStats.find_fn(timestamp, [&stats](const TimestampStats &s) { stats = s; });
+    return stats;
+}
+
+/**
+ * Sums up the counters of all timestamps in the given range with two binary searches over the prefix sums, which
+ * reflect the graph after the last applied batch. Does not lock anything.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return summed counters of the range
+ */
+TimestampStats AdjList::getWindowStats(uint64_t start, uint64_t end) const {
+    TimestampStats stats;
+    auto index = std::atomic_load(&statsIndex);
+    if (!index || start >= end) return stats;
+    size_t first = std::lower_bound(index->times.begin(), index->times.end(), start) - index->times.begin();
+    size_t last = std::lower_bound(index->times.begin(), index->times.end(), end) - index->times.begin();
+    stats.edges = index->prefix[last].edges - index->prefix[first].edges;
+    stats.sources = index->prefix[last].sources - index->prefix[first].sources;
+    stats.bytes = index->prefix[last].bytes - index->prefix[first].bytes;
+    return stats;
+}
+
+/**
+ * Recomputes the prefix sums over all timestamps and publishes them for getWindowStats. Linear in the number of
+ * timestamps, called once per batch.
+ */
+void AdjList::rebuildStatsIndex() {
+    auto index = std::make_shared<StatsIndex>();
+    index->times = timesInRange(0, std::numeric_limits<uint64_t>::max());
+    auto stats = parlay::tabulate(index->times.size(), [&](size_t i) { return getStats(index->times[i]); });
+
+    index->prefix.resize(stats.size() + 1);
+    for (size_t i = 0; i < stats.size(); i++) {
+        index->prefix[i + 1].edges = index->prefix[i].edges + stats[i].edges;
+        index->prefix[i + 1].sources = index->prefix[i].sources + stats[i].sources;
+        index->prefix[i + 1].bytes = index->prefix[i].bytes + stats[i].bytes;
+    }
+    std::atomic_store(&statsIndex, std::shared_ptr<const StatsIndex>(std::move(index)));
 }
 
 uint64_t AdjList::getDestSize(uint64_t timestamp, uint64_t source){
-    uint64_t destSize;
+    uint64_t destSize = 0;
     edges.find_fn(timestamp,[&source,&destSize](Edge &e){
        e.find_fn(source,[&destSize](std::vector<uint64_t>&destinations){
            destSize = destinations.size();
        });
     });
     return destSize;
-}
\ No newline at end of file
+}
+
+/**
+ * Enables or disables snapshot isolated reads. Enabling publishes a snapshot of the whole graph, afterwards every
+ * batch publishes a new version that only copies the sources it touched.
+ * @param enabled
+ */
+void AdjList::setSnapshotIsolation(bool enabled) {
+    std::lock_guard<std::mutex> writer(batchMutex);
+    snapshotsEnabled = enabled;
+    if (enabled) {
+        std::lock_guard<std::mutex> guard(publishMutex);
+        auto snapshot = std::make_shared<Snapshot>();
+        auto times = timesInRange(0, UINT64_MAX);
+        auto frozen = parlay::tabulate(times.size(), [&](size_t i) {
+            return refreshPartition(nullptr, times[i], nullptr);
+        }, 1);
+        for (auto &partition: frozen) {
+            if (partition) snapshot->partitions.emplace_hint(snapshot->partitions.end(), partition->time, partition);
+        }
+        auto previous = std::atomic_load(&published);
+        snapshot->version = previous ? previous->version + 1 : 1;
+        std::atomic_store(&published, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+    } else {
+        std::atomic_store(&published, std::shared_ptr<const Snapshot>());
+    }
+}
+
+/**
+ * Makes batches and queries independent of the number of workers and of their interleaving: the same sequence of
+ * batches yields the same tables, destination orders and query results. Batches are then applied with one task per
+ * timestamp and sources in ascending order, new timestamps are created serially and getVertices and
+ * computeComponents fill their maps serially.
+ * The cost is parallelism within a timestamp: a batch that touches fewer timestamps than there are workers is
+ * applied with fewer workers, plus sorting the sources of every touched timestamp (O(s log s)).
+ * @param enabled
+ */
+void AdjList::setDeterministic(bool enabled) {
+    deterministic = enabled;
+}
+
+/**
+ * Pins the latest published version. Never blocks on running batches, the returned snapshot stays valid and unchanged
+ * for as long as the caller holds it.
+ * @return latest snapshot or nullptr if snapshot isolation is disabled
+ */
+std::shared_ptr<const Snapshot> AdjList::pinSnapshot() const {
+    return std::atomic_load(&published);
+}
+
+/**
+ * Publishes a new version that shares all partitions with the previous one except @p touchedTimes. Within those only
+ * the touched sources are copied again from the live graph, the rest of their rows is shared as well. Timestamps
+ * that no longer exist are dropped. Called while batchMutex is held, so the version is the state after one batch.
+ * @param touchedTimes timestamps modified since the last publication
+ * @param touchedSources sources whose destinations changed, per touched timestamp and in any order
+ */
+void AdjList::publishSnapshot(const std::vector<uint64_t> &touchedTimes,
+                              const std::vector<std::vector<uint64_t>> &touchedSources) {
+    std::lock_guard<std::mutex> guard(publishMutex);
+    auto previous = std::atomic_load(&published);
+    auto snapshot = previous ? std::make_shared<Snapshot>(*previous) : std::make_shared<Snapshot>();
+
+    auto refreshed = parlay::tabulate(touchedTimes.size(), [&](size_t i) {
+        auto it = snapshot->partitions.find(touchedTimes[i]);
+        return refreshPartition(it == snapshot->partitions.end() ? nullptr : it->second.get(), touchedTimes[i],
+                                &touchedSources[i]);
+    }, 1);
+    for (size_t i = 0; i < touchedTimes.size(); i++) {
+        if (refreshed[i]) snapshot->partitions[touchedTimes[i]] = refreshed[i];
+        else snapshot->partitions.erase(touchedTimes[i]);
+    }
+    snapshot->version = previous ? previous->version + 1 : 1;
+    std::atomic_store(&published, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+}
+
+/**
+ * Builds the next version of one timestamp. Only the destinations of @p touched are copied while the timestamp is
+ * locked, one inner lookup each. Sorting them and merging them with the shared rows of @p previous happens after
+ * the lock was released.
+ * @param previous version of the timestamp, nullptr if it had none
+ * @param time timestamp to be refreshed
+ * @param touched sources to be copied again, nullptr copies all sources
+ * @return new version or nullptr if @p time is not in the graph
+ */
+std::shared_ptr<const SnapshotPartition>
+AdjList::refreshPartition(const SnapshotPartition *previous, uint64_t time, const std::vector<uint64_t> *touched) {
+    //source < copied destinations>, nullptr if the source has no edges anymore
+    std::vector<std::pair<uint64_t, std::shared_ptr<std::vector<uint64_t>>>> copies;
+    std::vector<uint64_t> sources;
+    if (touched != nullptr) {
+        sources = *touched;
+        std::sort(sources.begin(), sources.end());
+        sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+    }
+
+    bool found = edges.find_fn(time, [&](Edge &e) {
+        if (touched == nullptr) {
+            auto lt = e.lock_table();
+            copies.reserve(lt.size());
+            for (const auto &vector: lt) {
+                copies.emplace_back(vector.first, std::make_shared<std::vector<uint64_t>>(vector.second));
+            }
+            return;
+        }
+        copies.reserve(sources.size());
+        for (uint64_t source: sources) {
+            std::shared_ptr<std::vector<uint64_t>> copy;
+            e.find_fn(source, [&](const std::vector<uint64_t> &destinations) {
+                copy = std::make_shared<std::vector<uint64_t>>(destinations);
+            });
+            copies.emplace_back(source, std::move(copy));
+        }
+    });
+    if (!found) return nullptr;
+
+    if (touched == nullptr) {
+        std::sort(copies.begin(), copies.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    }
+    for (auto &copy: copies) {
+        if (copy.second) std::sort(copy.second->begin(), copy.second->end());
+    }
+
+    auto partition = std::make_shared<SnapshotPartition>();
+    partition->time = time;
+    size_t kept = previous ? previous->sources.size() : 0;
+    partition->sources.reserve(kept + copies.size());
+    partition->rows.reserve(kept + copies.size());
+    auto append = [&](uint64_t source, std::shared_ptr<const std::vector<uint64_t>> row) {
+        if (!row || row->empty()) return;
+        partition->edges += row->size();
+        partition->sources.push_back(source);
+        partition->rows.push_back(std::move(row));
+    };
+    size_t i = 0;
+    for (auto &copy: copies) {
+        for (; i < kept && previous->sources[i] < copy.first; i++) append(previous->sources[i], previous->rows[i]);
+        if (i < kept && previous->sources[i] == copy.first) i++;
+        append(copy.first, std::move(copy.second));
+    }
+    for (; i < kept; i++) append(previous->sources[i], previous->rows[i]);
+    return partition;
+}
+
+/**
+ * Copies one timestamp into an immutable CSR partition with sorted sources and destinations.
+ * @param time timestamp to be frozen
+ * @return frozen partition or nullptr if @p time is not in the graph
+ */
+std::shared_ptr<const FrozenPartition> AdjList::freezePartition(uint64_t time) {
+    std::vector<std::pair<uint64_t, const std::vector<uint64_t>*>> rows;
+    auto partition = std::make_shared<FrozenPartition>();
+    partition->time = time;
+
+    bool found = edges.find_fn(time, [&](Edge &e) {
+        auto lt = e.lock_table();
+        rows.reserve(lt.size());
+        for (const auto &vector: lt) rows.emplace_back(vector.first, &vector.second);
+        std::sort(rows.begin(), rows.end());
+
+        partition->sources.reserve(rows.size());
+        partition->offsets.reserve(rows.size() + 1);
+        partition->offsets.push_back(0);
+        for (const auto &row: rows) {
+            partition->sources.push_back(row.first);
+            partition->destinations.insert(partition->destinations.end(), row.second->begin(), row.second->end());
+            std::sort(partition->destinations.begin() + partition->offsets.back(), partition->destinations.end());
+            partition->offsets.push_back(partition->destinations.size());
+        }
+    });
+    if (!found) return nullptr;
+    return partition;
+}
@@ -3,50 +3,202 @@
 
 #include <set>
 #include <map>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include "libcuckoo/cuckoohash_map.hh"
+#include "parlay/parallel.h"
+#include "parlay/sequence.h"
+#include "components.h"
+#include "cores.h"
+#include "edge_export.h"
+#include "memory_report.h"
+#include "motifs.h"
+#include "pagerank.h"
+#include "snapshot.h"
+#include "temporal_paths.h"
+#include "triangles.h"
+#include "vertex_bitmap.h"
+#include "window_graph.h"
 
 typedef libcuckoo::cuckoohash_map<uint64_t, libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>>> NestedMap;
 
+//(source, destinations) of every source of one timestamp, copied out of the graph
+typedef std::vector<std::pair<uint64_t, std::vector<uint64_t>>> PartitionRows;
+
+struct EdgeKey{
+    uint64_t source;
+    uint64_t destination;
+    uint64_t time;
+};
+
+/**
+ * Counters of one timestamp or, summed up, of a range of timestamps. Edges are directed, so every undirected edge is
+ * counted twice. Bytes are the keys, vector headers and allocated destination capacity of the inner maps.
+ */
+struct TimestampStats{
+    uint64_t edges = 0;
+    uint64_t sources = 0;
+    uint64_t bytes = 0;
+};
+
 class AdjList{
 public:
     void addFromFile(const std::string& path);
+    void applyBatch(bool insert, const std::vector<uint64_t> &sources, const std::vector<uint64_t> &destinations,
+                    const std::vector<uint64_t> &times);
     void printGraph();
     size_t getSize();
     bool findEdge(uint64_t source, uint64_t destination, uint64_t time);
     bool findEdge(uint64_t source, uint64_t destination, uint64_t start, uint64_t end);
+    parlay::sequence<bool> findEdges(const std::vector<EdgeKey> &keys);
     void batchOperation(bool insert, NestedMap &groupedData);
     void batchOperationParlay(bool insert, NestedMap &groupedData, std::unordered_map<uint64_t, uint64_t> uniqueTimesMap);
     void rangeQuery(uint64_t start, uint64_t end, const std::function<void(uint64_t,uint64_t,uint64_t)> &func);
     uint64_t memoryConsumption();
+    MemoryReport getMemoryReport();
+    uint64_t getTimestampMemory(uint64_t timestamp);
     size_t getEdgeCount(uint64_t timestamp);
     uint64_t getInnerTblCount(uint64_t timestamp);
+    TimestampStats getStats(uint64_t timestamp);
+    TimestampStats getWindowStats(uint64_t start, uint64_t end) const;
     uint64_t getDestSize(uint64_t timestamp, uint64_t source);
+    parlay::sequence<uint64_t> getDestSizes(const std::vector<std::pair<uint64_t, uint64_t>> &keys);
     libcuckoo::cuckoohash_map<uint64_t, bool> getVertices(uint64_t start, uint64_t end);
+    VertexBitmap getVertexBitmap(uint64_t start, uint64_t end);
+    template<typename F>
+    void visitRange(uint64_t start, uint64_t end, F &&f);
     libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>>
     getNeighboursOld(uint64_t start, uint64_t end, uint64_t source);
     libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> computeComponents(uint64_t start, uint64_t end);
+    ComponentLabels connectedComponents(uint64_t start, uint64_t end);
+    WindowGraph getWindowGraph(uint64_t start, uint64_t end);
+    PageRankResult pageRank(uint64_t start, uint64_t end, const PageRankOptions &options);
+    TriangleCounts countTriangles(uint64_t start, uint64_t end);
+    CoreNumbers coreDecomposition(uint64_t start, uint64_t end);
+    TemporalMotifCounts countTemporalMotifs(uint64_t start, uint64_t end, uint64_t delta);
+    void setIncrementalComponents(bool enabled);
+    uint64_t getComponentId(uint64_t vertex);
+    uint64_t getComponentSize(uint64_t vertex);
+    uint64_t getComponentCount();
+    void setIncrementalTriangles(bool enabled);
+    uint64_t getTriangleCount();
+    uint64_t getVertexTriangles(uint64_t vertex);
+    void setIncrementalCores(bool enabled);
+    uint64_t getCoreNumber(uint64_t vertex);
+    uint64_t getDegeneracy();
+    TemporalLabels earliestArrival(uint64_t source, uint64_t start, uint64_t end);
+    TemporalLabels latestDeparture(uint64_t target, uint64_t start, uint64_t end);
+    TemporalLabels fastestPaths(uint64_t source, uint64_t start, uint64_t end);
+    parlay::sequence<uint64_t> temporalReachable(uint64_t source, uint64_t start, uint64_t end);
+    MultiSourceArrivals earliestArrivals(const std::vector<uint64_t> &sources, uint64_t start, uint64_t end);
+    void diffWindows(uint64_t oldStart, uint64_t oldEnd, uint64_t newStart, uint64_t newEnd,
+                     const std::function<void(uint64_t, uint64_t)> &added,
+                     const std::function<void(uint64_t, uint64_t)> &removed);
+    void setRetentionWindow(uint64_t window);
+    size_t evictBefore(uint64_t horizon);
+    void setSnapshotIsolation(bool enabled);
+    void setDeterministic(bool enabled);
+    uint64_t exportRange(uint64_t start, uint64_t end, const std::string &path, ExportFormat format);
+    std::shared_ptr<const Snapshot> pinSnapshot() const;
 
 
 private:
+    friend class ShardedAdjList;
+    friend class EdgeCursor;
+
     //time < source < list of destinations>>
     NestedMap edges;
     std::set<uint64_t> uniqueTimestamps;
+    //guards uniqueTimestamps, batches and evictions may modify it concurrently
+    std::mutex timestampsMutex;
+    //number of most recent time units that are kept, 0 keeps everything
+    uint64_t retentionWindow = 0;
+    //latest published version, only maintained while snapshot isolation is enabled
+    std::shared_ptr<const Snapshot> published;
+    std::mutex publishMutex;
+    std::atomic<bool> snapshotsEnabled{false};
+    //serializes batches and evictions, so every published snapshot is the state after one complete batch
+    std::mutex batchMutex;
+    //batches and queries produce the same layout and results independent of the number of workers
+    bool deterministic = false;
+    //time < vertices that have at least one edge at that time>, copied on write while getVertexBitmap references it
+    libcuckoo::cuckoohash_map<uint64_t, std::shared_ptr<VertexBitmap>> vertexBitmaps;
+    //time < counters of that time>, updated under the lock of the timestamp
+    libcuckoo::cuckoohash_map<uint64_t, TimestampStats> timestampStats;
+
+    //components of the whole graph, only maintained while enabled
+    bool componentsEnabled = false;
+    IncrementalComponents incrementalComponents;
+    std::mutex componentsMutex;
+
+    //triangles of the whole graph, only maintained while enabled
+    bool trianglesEnabled = false;
+    IncrementalTriangles incrementalTriangles;
+    std::mutex trianglesMutex;
+
+    //core numbers of the whole graph, only maintained while enabled
+    bool coresEnabled = false;
+    IncrementalCores incrementalCores;
+    std::mutex coresMutex;
+
+    //sorted timestamps with the prefix sums of their counters, prefix[i] covers times[0, i)
+    struct StatsIndex{
+        std::vector<uint64_t> times;
+        std::vector<TimestampStats> prefix;
+    };
+    //rebuilt after every batch, readers load it without locking
+    std::shared_ptr<const StatsIndex> statsIndex;
+
+    //changes of one timestamp that are applied to its counters and vertex bitmap at once
+    struct PartitionDelta{
+        TimestampStats gained;
+        TimestampStats lost;
+        std::vector<uint64_t> addedSources;
+        std::vector<uint64_t> removedSources;
+    };
 
     //TODO: std::unorderedmap<uint64_t, libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>>>
     //TODO: std::map<uint64_t, libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>>>
     static void insertEdgeDirected(uint64_t source, uint64_t destination, uint64_t time, NestedMap &map);
+    bool insertEdgeDirectedUnique(uint64_t source, uint64_t destination, uint64_t time);
+    static bool insertIntoPartition(libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> &e, uint64_t source,
+                                    uint64_t destination, PartitionDelta &delta);
+    static bool eraseFromPartition(libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> &e, uint64_t source,
+                                   uint64_t destination, PartitionDelta &delta);
+    void applyDelta(uint64_t time, const PartitionDelta &delta);
+    void eraseIfEmpty(uint64_t time);
     void insertEdgeUndirected(uint64_t source, uint64_t destination, uint64_t time);
     void deleteEdgeDirected(uint64_t source, uint64_t destination, uint64_t time);
     void deleteEdgeUndirected(uint64_t source, uint64_t destination, uint64_t time);
+    bool applyDirected(bool insert, uint64_t source, uint64_t destination, uint64_t time);
     static void sortBatch(const std::vector<uint64_t>& sourceAdds, const std::vector<uint64_t>& destinationAdds,
                           const std::vector<uint64_t>& timeAdds, NestedMap &groupedData);
     static void printGroupedData(NestedMap &groupedData);
     static void fileReaderHelper(std::vector<uint64_t> &sourceVector, std::vector<uint64_t> &destinationVector,
-                          std::vector<uint64_t> &timeVector, std::set<uint64_t> &uniqueTimes, uint64_t source,
-                          uint64_t destination, uint64_t time);
+                          std::vector<uint64_t> &timeVector, uint64_t source, uint64_t destination, uint64_t time);
     void uniqueTimesHelper(std::unordered_map<uint64_t, uint64_t> &uniqueTimesMap, std::set<uint64_t> &uniqueTimes, bool insert);
     std::map<uint64_t, uint64_t> genUniqueTimeMap(uint64_t start, uint64_t end);
+    std::vector<uint64_t> timesInRange(uint64_t start, uint64_t end);
+    PartitionRows copyRows(uint64_t time);
+    bool nextTimestamp(uint64_t from, uint64_t end, uint64_t &time);
+    parlay::sequence<std::pair<uint64_t, uint64_t>> windowPairs(uint64_t start, uint64_t end);
+    template<typename Keep>
+    parlay::sequence<std::pair<uint64_t, uint64_t>> collectPairs(const std::vector<uint64_t> &times, Keep &&keep);
+    void updateComponents(bool insert, const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    void refreshComponents();
+    parlay::sequence<std::pair<uint64_t, uint64_t>> changingPairs(bool insert, parlay::sequence<EdgeKey> keys);
+    void updateTriangles(bool insert, const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    void updateCores(bool insert, const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    void publishSnapshot(const std::vector<uint64_t> &touchedTimes,
+                         const std::vector<std::vector<uint64_t>> &touchedSources);
+    std::shared_ptr<const SnapshotPartition>
+    refreshPartition(const SnapshotPartition *previous, uint64_t time, const std::vector<uint64_t> *touched);
+    void rebuildStatsIndex();
+    std::shared_ptr<const FrozenPartition> freezePartition(uint64_t time);
+    template<typename F>
+    void sweepPartitions(const std::vector<uint64_t> &times, const parlay::sequence<uint64_t> &vertices, F &&f);
     template<typename F>
     void rangeQueryToSourceParlay(uint64_t start, uint64_t end, F &&f);
     template<typename F>
@@ -68,9 +220,32 @@ private:
     computeComponentsHelper(uint64_t start, uint64_t end, libcuckoo::cuckoohash_map<uint64_t, bool> &allNodes,
                             uint64_t key,
                             libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> &components, uint64_t cKey);
-    template<typename F>
-    void rangeQueryToTimeParlay(uint64_t start, uint64_t end, F &&f);
+    template<typename GetTime, typename GetSource, typename F>
+    void lookupBatch(size_t n, GetTime &&getTime, GetSource &&getSource, F &&f);
 
 };
 
+/**
+ * Calls @p f(time, source, destinations) for every source that has edges within the given range. The destinations are
+ * a span into the stored vector, so nothing is copied and the cost is proportional to the visited edges.
+ * Timestamps are visited in parallel while they are locked, @p f must not modify or query the graph.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @param f
+ */
+template<typename F>
+void AdjList::visitRange(uint64_t start, uint64_t end, F &&f) {
+    auto times = timesInRange(start, end);
+    parlay::parallel_for(0, times.size(), [&](size_t i) {
+        uint64_t time = times[i];
+        edges.find_fn(time, [&](libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> &e) {
+            auto lt = e.lock_table();
+            for (const auto &vector: lt) {
+                const uint64_t *destinations = vector.second.data();
+                f(time, vector.first, DestinationSpan(destinations, destinations + vector.second.size()));
+            }
+        });
+    }, 1);
+}
+
 #endif //TEMPUS_ADJ_LIST_H
@@ -0,0 +1,224 @@
+#include "components.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * @param n number of elements, every element starts in its own set
+ */
+ConcurrentUnionFind::ConcurrentUnionFind(size_t n) : parents(n) {
+    parlay::parallel_for(0, n, [&](size_t i) { parents[i].store(i, std::memory_order_relaxed); });
+}
+
+/**
+ * @param x element
+ * @return representative of the set of @p x
+ */
+uint64_t ConcurrentUnionFind::find(uint64_t x) {
+    while (true) {
+        uint64_t parent = parents[x].load(std::memory_order_acquire);
+        if (parent == x) return x;
+        uint64_t grandparent = parents[parent].load(std::memory_order_acquire);
+        //path halving, a failed exchange only means another thread already shortened the path
+        if (parent != grandparent) parents[x].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+        x = grandparent;
+    }
+}
+
+/**
+ * Merges the sets of @p a and @p b.
+ * @param a element
+ * @param b element
+ * @return false if both already were in the same set
+ */
+bool ConcurrentUnionFind::unite(uint64_t a, uint64_t b) {
+    while (true) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (a < b) std::swap(a, b);
+        uint64_t expected = a;
+        if (parents[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return true;
+    }
+}
+
+size_t ConcurrentUnionFind::size() const {
+    return parents.size();
+}
+
+/**
+ * @param vertex
+ * @return position of @p vertex in vertices, or max uint64 if it has no edge in the window
+ */
+uint64_t ComponentLabels::indexOf(uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return std::numeric_limits<uint64_t>::max();
+    return it - vertices.begin();
+}
+
+/**
+ * @param vertex
+ * @return component of @p vertex, or max uint64 if it has no edge in the window
+ */
+uint64_t ComponentLabels::componentOf(uint64_t vertex) const {
+    uint64_t index = indexOf(vertex);
+    if (index == std::numeric_limits<uint64_t>::max()) return index;
+    return components[index];
+}
+
+void IncrementalComponents::clear() {
+    index.clear();
+    vertices.clear();
+    parents.clear();
+    sizes.clear();
+    dirty.clear();
+    reset.clear();
+    anyDirty = false;
+    components = 0;
+}
+
+/**
+ * Finds the root of @p x and points every vertex on the way directly to it.
+ * @param x index of a vertex
+ * @return index of the root
+ */
+uint64_t IncrementalComponents::find(uint64_t x) {
+    uint64_t root = x;
+    while (parents[root] != root) root = parents[root];
+    while (parents[x] != root) {
+        uint64_t next = parents[x];
+        parents[x] = root;
+        x = next;
+    }
+    return root;
+}
+
+/**
+ * Same as find without path compression, so it can be called from parallel loops.
+ * @param x index of a vertex
+ * @return index of the root
+ */
+uint64_t IncrementalComponents::findReadOnly(uint64_t x) const {
+    while (parents[x] != x) x = parents[x];
+    return x;
+}
+
+/**
+ * Union by size. A dirty component stays dirty when it absorbs or is absorbed by another one.
+ * @param a index of a vertex
+ * @param b index of a vertex
+ */
+void IncrementalComponents::unite(uint64_t a, uint64_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return;
+    if (sizes[a] < sizes[b]) std::swap(a, b);
+    parents[b] = a;
+    sizes[a] += sizes[b];
+    //only roots are dirty, resetDirty counts them as the number of components it splits
+    dirty[a] |= dirty[b];
+    dirty[b] = 0;
+    components--;
+}
+
+/**
+ * Registers unknown vertices and merges the components of every pair. Unknown vertices are added serially in
+ * ascending order, then parallel read only finds drop the pairs that already lie in one component, which after
+ * the first batches are most of them. Only the remaining pairs are united serially.
+ * @param pairs edges as vertex pairs
+ */
+void IncrementalComponents::addEdges(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    auto endpoints = parlay::tabulate(2 * pairs.size(), [&](size_t i) {
+        return i % 2 == 0 ? pairs[i / 2].first : pairs[i / 2].second;
+    });
+    auto unknown = parlay::filter(endpoints, [&](uint64_t vertex) { return index.find(vertex) == index.end(); });
+    parlay::sort_inplace(unknown);
+    for (uint64_t vertex: parlay::unique(unknown)) {
+        index.emplace(vertex, vertices.size());
+        parents.push_back(vertices.size());
+        vertices.push_back(vertex);
+        sizes.push_back(1);
+        dirty.push_back(0);
+        reset.push_back(0);
+        components++;
+    }
+
+    auto merging = parlay::filter(pairs, [&](const std::pair<uint64_t, uint64_t> &pair) {
+        return findReadOnly(index.at(pair.first)) != findReadOnly(index.at(pair.second));
+    });
+    for (const auto &pair: merging) unite(index.at(pair.first), index.at(pair.second));
+}
+
+/**
+ * Marks the components of deleted edges. They are only recomputed once they are queried.
+ * @param pairs deleted edges as vertex pairs
+ */
+void IncrementalComponents::markDirty(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    for (const auto &pair: pairs) {
+        auto it = index.find(pair.first);
+        if (it == index.end()) continue;
+        dirty[find(it->second)] = 1;
+        anyDirty = true;
+    }
+}
+
+/**
+ * Splits every dirty component into singletons. The caller has to pass all edges between vertices for which
+ * wasReset is true to addEdges afterwards.
+ * @return false if no component was dirty
+ */
+bool IncrementalComponents::resetDirty() {
+    if (!anyDirty) return false;
+    size_t n = vertices.size();
+    parlay::parallel_for(0, n, [&](size_t i) { reset[i] = dirty[findReadOnly(i)]; });
+    uint64_t dirtyRoots = parlay::count(dirty, uint8_t(1));
+    uint64_t resetVertices = parlay::count(reset, uint8_t(1));
+    parlay::parallel_for(0, n, [&](size_t i) {
+        if (reset[i]) {
+            parents[i] = i;
+            sizes[i] = 1;
+        }
+        dirty[i] = 0;
+    });
+    components += resetVertices - dirtyRoots;
+    anyDirty = false;
+    return true;
+}
+
+/**
+ * @param vertex
+ * @return true if the component of @p vertex was split by the last resetDirty
+ */
+bool IncrementalComponents::wasReset(uint64_t vertex) const {
+    auto it = index.find(vertex);
+    return it != index.end() && reset[it->second];
+}
+
+/**
+ * @param vertex
+ * @return representative vertex of the component of @p vertex, max uint64 if @p vertex never had an edge
+ */
+uint64_t IncrementalComponents::componentOf(uint64_t vertex) {
+    auto it = index.find(vertex);
+    if (it == index.end()) return std::numeric_limits<uint64_t>::max();
+    return vertices[find(it->second)];
+}
+
+/**
+ * @param vertex
+ * @return number of vertices in the component of @p vertex, 0 if @p vertex never had an edge
+ */
+uint64_t IncrementalComponents::sizeOf(uint64_t vertex) {
+    auto it = index.find(vertex);
+    if (it == index.end()) return 0;
+    return sizes[find(it->second)];
+}
+
+/**
+ * @return number of components, vertices that lost all their edges count as singletons
+ */
+uint64_t IncrementalComponents::count() const {
+    return components;
+}
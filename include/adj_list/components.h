@@ -0,0 +1,74 @@
+#ifndef TEMPUS_COMPONENTS_H
+#define TEMPUS_COMPONENTS_H
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "parlay/sequence.h"
+
+/**
+ * Lock free union find over the indices 0 to n - 1. Roots are always linked below the smaller index, so after all
+ * unions every set is represented by its smallest index, independent of the order of the operations.
+ * find compresses paths by halving, all operations may run concurrently.
+ */
+class ConcurrentUnionFind{
+public:
+    explicit ConcurrentUnionFind(size_t n);
+    uint64_t find(uint64_t x);
+    bool unite(uint64_t a, uint64_t b);
+    size_t size() const;
+
+private:
+    std::vector<std::atomic<uint64_t>> parents;
+};
+
+/**
+ * Dense result of a connected components computation. @p components[i] is the component of @p vertices[i], the
+ * components are numbered from 0 in the order of their smallest vertex.
+ */
+struct ComponentLabels{
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<uint64_t> components;
+    uint64_t count = 0;
+
+    uint64_t componentOf(uint64_t vertex) const;
+    uint64_t indexOf(uint64_t vertex) const;
+};
+
+/**
+ * Connected components of a growing graph. Vertices are registered on their first edge and keep their index.
+ * Insertions are unions, deletions only mark the component of the edge as dirty. Dirty components are reset to
+ * singletons by resetDirty and rebuilt from the edges that the owner passes to addEdges afterwards.
+ * Not thread safe, the owner serializes all calls.
+ */
+class IncrementalComponents{
+public:
+    void clear();
+    void addEdges(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    void markDirty(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    bool resetDirty();
+    bool wasReset(uint64_t vertex) const;
+    uint64_t componentOf(uint64_t vertex);
+    uint64_t sizeOf(uint64_t vertex);
+    uint64_t count() const;
+
+private:
+    std::unordered_map<uint64_t, uint64_t> index;
+    std::vector<uint64_t> vertices;
+    std::vector<uint64_t> parents;
+    std::vector<uint64_t> sizes;
+    //set for roots of components that lost an edge
+    std::vector<uint8_t> dirty;
+    //set for vertices whose component was reset by the last resetDirty
+    std::vector<uint8_t> reset;
+    bool anyDirty = false;
+    uint64_t components = 0;
+
+    uint64_t find(uint64_t x);
+    uint64_t findReadOnly(uint64_t x) const;
+    void unite(uint64_t a, uint64_t b);
+};
+
+#endif //TEMPUS_COMPONENTS_H
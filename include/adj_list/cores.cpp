@@ -0,0 +1,275 @@
+#include "cores.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+/**
+ * Appends every vertex to the bucket of its degree, vertices with the same degree are appended at once.
+ * @param buckets one bucket per degree, grown as needed
+ * @param moved vertex indices
+ * @param degrees current degree per vertex index
+ */
+void addToBuckets(std::vector<parlay::sequence<uint64_t>> &buckets, const parlay::sequence<uint64_t> &moved,
+                  const parlay::sequence<uint64_t> &degrees) {
+    auto keyed = parlay::map(moved, [&](uint64_t v) { return std::make_pair(degrees[v], v); });
+    parlay::sort_inplace(keyed);
+    auto starts = parlay::pack_index(parlay::tabulate(keyed.size() + 1, [&](size_t i) {
+        return i == 0 || i == keyed.size() || keyed[i].first != keyed[i - 1].first;
+    }));
+    for (size_t i = 0; i + 1 < starts.size(); i++) {
+        uint64_t degree = keyed[starts[i]].first;
+        if (degree >= buckets.size()) buckets.resize(degree + 1);
+        buckets[degree].append(parlay::delayed_tabulate(starts[i + 1] - starts[i], [&](size_t j) {
+            return keyed[starts[i] + j].second;
+        }));
+    }
+}
+
+}
+
+/**
+ * @param vertex
+ * @return core number of @p vertex, 0 if it has no edge in the window
+ */
+uint64_t CoreNumbers::coreOf(uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return 0;
+    return cores[it - vertices.begin()];
+}
+
+/**
+ * Bucketed peeling as in the k-core example of parlay. Vertices wait in the bucket of their current degree, the
+ * rounds peel all vertices of the lowest non empty bucket k at once and subtract the peeled edges from the degrees
+ * of their neighbours in parallel, counted by sorting the neighbours. Degrees never drop below k, so a peeled vertex
+ * has core number k. A vertex whose degree dropped is appended to its new bucket, the entry in its old bucket is
+ * skipped when that bucket is reached.
+ * @param graph window to decompose
+ * @return core numbers of all vertices of @p graph
+ */
+CoreNumbers computeCores(const WindowGraph &graph) {
+    CoreNumbers result;
+    result.vertices = graph.getVertices();
+    size_t n = graph.numVertices();
+    if (n == 0) return result;
+
+    auto degrees = parlay::tabulate(n, [&](size_t i) -> uint64_t { return graph.degree(i); });
+    parlay::sequence<bool> peeled(n, false);
+    std::vector<parlay::sequence<uint64_t>> buckets;
+    addToBuckets(buckets, parlay::tabulate(n, [](size_t i) -> uint64_t { return i; }), degrees);
+
+    size_t finished = 0;
+    uint64_t k = 0;
+    while (finished < n) {
+        auto frontier = parlay::filter(buckets[k], [&](uint64_t v) { return !peeled[v] && degrees[v] == k; });
+        buckets[k].clear();
+        if (frontier.empty()) {
+            k++;
+            continue;
+        }
+        //a vertex can be appended to the same bucket in several rounds
+        parlay::sort_inplace(frontier);
+        frontier = parlay::unique(frontier);
+        parlay::parallel_for(0, frontier.size(), [&](size_t i) { peeled[frontier[i]] = true; });
+        finished += frontier.size();
+        result.degeneracy = k;
+
+        auto touched = parlay::filter(parlay::flatten(parlay::map(frontier, [&](uint64_t v) {
+            return parlay::to_sequence(graph.neighbours(v));
+        })), [&](uint64_t u) { return !peeled[u] && degrees[u] > k; });
+        parlay::sort_inplace(touched);
+        auto starts = parlay::pack_index(parlay::tabulate(touched.size() + 1, [&](size_t i) {
+            return i == 0 || i == touched.size() || touched[i] != touched[i - 1];
+        }));
+        auto moved = parlay::tabulate(starts.size() - 1, [&](size_t i) {
+            uint64_t u = touched[starts[i]];
+            degrees[u] = std::max(k, degrees[u] - (starts[i + 1] - starts[i]));
+            return u;
+        });
+        addToBuckets(buckets, moved, degrees);
+    }
+    result.cores = std::move(degrees);
+    return result;
+}
+
+void IncrementalCores::clear() {
+    adjacency.clear();
+    cores.clear();
+    coreSizes.clear();
+}
+
+/**
+ * Adds one timestamp to every pair. The edges that are new to the simple graph are inserted and their core numbers
+ * updated one edge at a time.
+ * @param pairs edges as vertex pairs, once per timestamp that gained the edge
+ */
+void IncrementalCores::addOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    for (const auto &[pair, occurrences]: countOccurrences(pairs)) {
+        uint64_t &multiplicity = adjacency[pair.first][pair.second];
+        bool inserted = multiplicity == 0;
+        multiplicity += occurrences;
+        adjacency[pair.second][pair.first] += occurrences;
+        if (inserted) insertEdge(pair.first, pair.second);
+    }
+}
+
+/**
+ * Removes one timestamp from every pair. The edges that leave the simple graph are erased and their core numbers
+ * updated one edge at a time.
+ * @param pairs edges as vertex pairs, once per timestamp that lost the edge
+ */
+void IncrementalCores::removeOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    for (const auto &[pair, occurrences]: countOccurrences(pairs)) {
+        auto it = adjacency.find(pair.first);
+        if (it == adjacency.end()) continue;
+        auto edge = it->second.find(pair.second);
+        if (edge == it->second.end()) continue;
+        uint64_t remaining = edge->second - std::min(edge->second, occurrences);
+        if (remaining > 0) {
+            edge->second = remaining;
+            adjacency[pair.second][pair.first] = remaining;
+            continue;
+        }
+        for (auto [a, b]: {pair, std::make_pair(pair.second, pair.first)}) {
+            auto of = adjacency.find(a);
+            of->second.erase(b);
+            if (of->second.empty()) adjacency.erase(of);
+        }
+        removeEdge(pair.first, pair.second);
+    }
+}
+
+/**
+ * @param vertex
+ * @return core number of @p vertex, 0 if it has no edge
+ */
+uint64_t IncrementalCores::coreOf(uint64_t vertex) const {
+    auto it = cores.find(vertex);
+    return it == cores.end() ? 0 : it->second;
+}
+
+/**
+ * @return largest core number of the simple graph
+ */
+uint64_t IncrementalCores::degeneracy() const {
+    return coreSizes.empty() ? 0 : coreSizes.rbegin()->first;
+}
+
+/**
+ * @param vertex
+ * @param core new core number, 0 forgets the vertex
+ */
+void IncrementalCores::setCore(uint64_t vertex, uint64_t core) {
+    auto it = cores.find(vertex);
+    if (it != cores.end()) {
+        auto size = coreSizes.find(it->second);
+        if (--size->second == 0) coreSizes.erase(size);
+        if (core == 0) cores.erase(it);
+        else it->second = core;
+    } else if (core > 0) {
+        cores.emplace(vertex, core);
+    }
+    if (core > 0) coreSizes[core]++;
+}
+
+/**
+ * Called after the edge was added to the adjacency. With k the smaller core number of its endpoints, only the
+ * vertices with core number k that are connected to an endpoint with core number k over such vertices can rise, and
+ * only to k + 1. Those vertices are collected, every one counts its neighbours with core number at least k and
+ * vertices with at most k such neighbours are evicted until the rest all have more than k. The rest rises.
+ * @param u
+ * @param v
+ */
+void IncrementalCores::insertEdge(uint64_t u, uint64_t v) {
+    uint64_t k = std::min(coreOf(u), coreOf(v));
+    //candidate < neighbours with core number at least k that were not evicted>
+    std::unordered_map<uint64_t, uint64_t> support;
+    std::vector<uint64_t> stack;
+    for (uint64_t root: {u, v}) {
+        if (coreOf(root) == k && support.emplace(root, 0).second) stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        uint64_t x = stack.back();
+        stack.pop_back();
+        for (const auto &neighbour: adjacency.at(x)) {
+            uint64_t core = coreOf(neighbour.first);
+            if (core >= k) support[x]++;
+            if (core == k && support.emplace(neighbour.first, 0).second) stack.push_back(neighbour.first);
+        }
+    }
+
+    std::unordered_set<uint64_t> evicted;
+    for (const auto &[x, count]: support) {
+        if (count <= k) {
+            evicted.insert(x);
+            stack.push_back(x);
+        }
+    }
+    while (!stack.empty()) {
+        uint64_t x = stack.back();
+        stack.pop_back();
+        for (const auto &neighbour: adjacency.at(x)) {
+            auto it = support.find(neighbour.first);
+            if (it == support.end() || evicted.count(neighbour.first) > 0) continue;
+            if (--it->second <= k) {
+                evicted.insert(neighbour.first);
+                stack.push_back(neighbour.first);
+            }
+        }
+    }
+    for (const auto &candidate: support) {
+        if (evicted.count(candidate.first) == 0) setCore(candidate.first, k + 1);
+    }
+}
+
+/**
+ * Called after the edge was erased from the adjacency. With k the smaller core number of its endpoints, a vertex with
+ * core number k drops to k - 1 once fewer than k of its neighbours have core number at least k. Every drop is
+ * passed on to the neighbours with core number k right away, so a neighbour counts its supporters either before or
+ * after the drop but never twice.
+ * @param u
+ * @param v
+ */
+void IncrementalCores::removeEdge(uint64_t u, uint64_t v) {
+    uint64_t k = std::min(coreOf(u), coreOf(v));
+    if (k == 0) return;
+    //vertex with core number k < neighbours with core number at least k>
+    std::unordered_map<uint64_t, uint64_t> support;
+    std::vector<uint64_t> stack;
+    auto countSupport = [&](uint64_t x) {
+        uint64_t count = 0;
+        auto it = adjacency.find(x);
+        if (it == adjacency.end()) return count;
+        for (const auto &neighbour: it->second) count += coreOf(neighbour.first) >= k;
+        return count;
+    };
+    auto drop = [&](uint64_t x) {
+        setCore(x, k - 1);
+        auto it = adjacency.find(x);
+        if (it == adjacency.end()) return;
+        for (const auto &neighbour: it->second) {
+            uint64_t w = neighbour.first;
+            if (coreOf(w) != k) continue;
+            auto count = support.find(w);
+            if (count == support.end()) count = support.emplace(w, countSupport(w)).first;
+            else count->second--;
+            if (count->second < k) stack.push_back(w);
+        }
+    };
+
+    for (uint64_t root: {u, v}) {
+        if (coreOf(root) != k) continue;
+        auto count = support.find(root);
+        if (count == support.end()) count = support.emplace(root, countSupport(root)).first;
+        if (count->second < k) stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        uint64_t x = stack.back();
+        stack.pop_back();
+        if (coreOf(x) == k) drop(x);
+    }
+}
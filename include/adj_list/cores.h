@@ -0,0 +1,54 @@
+#ifndef TEMPUS_CORES_H
+#define TEMPUS_CORES_H
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include "parlay/sequence.h"
+#include "window_graph.h"
+
+/**
+ * Core numbers of a window. @p cores[i] belongs to @p vertices[i], the core number of a vertex is the largest k such
+ * that it is part of a subgraph in which every vertex has at least k neighbours. The degeneracy is the largest core
+ * number.
+ */
+struct CoreNumbers{
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<uint64_t> cores;
+    uint64_t degeneracy = 0;
+
+    uint64_t coreOf(uint64_t vertex) const;
+};
+
+CoreNumbers computeCores(const WindowGraph &graph);
+
+/**
+ * Core numbers of the simple graph that contains every edge of any timestamp, maintained under batches. Edges keep
+ * the number of timestamps that contain them like in IncrementalTriangles, and only an edge that enters or leaves the
+ * simple graph changes core numbers. Every such edge changes core numbers by at most one, only within the connected
+ * vertices that share the core number of its lower endpoint, so each edge only traverses that part of the graph.
+ * Not thread safe, the owner serializes all calls.
+ */
+class IncrementalCores{
+public:
+    void clear();
+    void addOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    void removeOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    uint64_t coreOf(uint64_t vertex) const;
+    uint64_t degeneracy() const;
+
+private:
+    //vertex < neighbour < number of timestamps that contain the edge>>
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, uint64_t>> adjacency;
+    //vertex < core number>, vertices without neighbours are not stored
+    std::unordered_map<uint64_t, uint64_t> cores;
+    //core number < number of vertices with that core number>
+    std::map<uint64_t, uint64_t> coreSizes;
+
+    void setCore(uint64_t vertex, uint64_t core);
+    void insertEdge(uint64_t u, uint64_t v);
+    void removeEdge(uint64_t u, uint64_t v);
+};
+
+#endif //TEMPUS_CORES_H
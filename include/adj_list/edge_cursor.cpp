@@ -0,0 +1,152 @@
+#include "edge_cursor.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * Opens a cursor at the first edge of the range.
+ * @param graph graph to read from
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @param sortSources visit the sources of every timestamp in ascending order
+ */
+EdgeCursor::EdgeCursor(AdjList &graph, uint64_t start, uint64_t end, bool sortSources)
+        : graph(graph), end(end), sortSources(sortSources) {
+    seek(start, nullptr);
+}
+
+/**
+ * Resumes a cursor at the position described by @p token.
+ * @param graph graph to read from
+ * @param token position returned by EdgeCursor::token
+ * @param end of the range exclusive
+ * @param sortSources has to match the cursor that created @p token
+ */
+EdgeCursor::EdgeCursor(AdjList &graph, const CursorToken &token, uint64_t end, bool sortSources)
+        : graph(graph), end(end), sortSources(sortSources) {
+    if (token.finished) done = true;
+    else seek(token.time, &token);
+}
+
+/**
+ * Moves to the first edge at or after @p from. If @p token is given and its timestamp still exists, the source and
+ * offset of the token are restored as well.
+ * @param from
+ * @param token
+ */
+void EdgeCursor::seek(uint64_t from, const CursorToken *token) {
+    if (!graph.nextTimestamp(from, end, time)) {
+        done = true;
+        return;
+    }
+    loadSources();
+    sourceIndex = 0;
+    if (token && time == token->time) {
+        if (sortSources) {
+            //sources that were removed since the token was taken are skipped
+            sourceIndex = std::lower_bound(sources.begin(), sources.end(), token->source) - sources.begin();
+        } else {
+            auto it = std::find(sources.begin(), sources.end(), token->source);
+            if (it != sources.end()) sourceIndex = it - sources.begin();
+        }
+    }
+    if (!advance()) return;
+    if (token && time == token->time && sources[sourceIndex] == token->source) {
+        offset = std::min<size_t>(token->offset, destinations.size());
+    }
+}
+
+/**
+ * Collects the sources of the current timestamp.
+ */
+void EdgeCursor::loadSources() {
+    sources.clear();
+    graph.edges.find_fn(time, [&](libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> &e) {
+        auto lt = e.lock_table();
+        sources.reserve(lt.size());
+        for (const auto &vector: lt) sources.push_back(vector.first);
+    });
+    if (sortSources) std::sort(sources.begin(), sources.end());
+}
+
+/**
+ * Copies the destinations of the current source.
+ * @return false if the source has no destinations anymore
+ */
+bool EdgeCursor::loadDestinations() {
+    destinations.clear();
+    offset = 0;
+    uint64_t source = sources[sourceIndex];
+    graph.edges.find_fn(time, [&](libcuckoo::cuckoohash_map<uint64_t, std::vector<uint64_t>> &e) {
+        e.find_fn(source, [&](const std::vector<uint64_t> &d) { destinations = d; });
+    });
+    return !destinations.empty();
+}
+
+/**
+ * Moves from the current source to the next one that has destinations, continuing with later timestamps if the
+ * current one is exhausted.
+ * @return false if the range contains no further edges
+ */
+bool EdgeCursor::advance() {
+    while (true) {
+        for (; sourceIndex < sources.size(); sourceIndex++) {
+            if (loadDestinations()) return true;
+        }
+        if (time == std::numeric_limits<uint64_t>::max() || !graph.nextTimestamp(time + 1, end, time)) {
+            done = true;
+            destinations.clear();
+            return false;
+        }
+        loadSources();
+        sourceIndex = 0;
+    }
+}
+
+/**
+ * @param edge receives the next edge
+ * @return false if all edges of the range have been returned
+ */
+bool EdgeCursor::next(EdgeKey &edge) {
+    if (done) return false;
+    if (offset >= destinations.size()) {
+        sourceIndex++;
+        if (!advance()) return false;
+    }
+    edge = {sources[sourceIndex], destinations[offset], time};
+    offset++;
+    return true;
+}
+
+/**
+ * Appends up to @p limit edges to @p out.
+ * @param limit
+ * @param out
+ * @return number of appended edges, less than @p limit only at the end of the range
+ */
+size_t EdgeCursor::fetch(size_t limit, std::vector<EdgeKey> &out) {
+    size_t count = 0;
+    EdgeKey edge{};
+    while (count < limit && next(edge)) {
+        out.push_back(edge);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @return position of the next edge, can be passed to a new cursor to continue from here
+ */
+CursorToken EdgeCursor::token() const {
+    CursorToken token;
+    token.finished = done;
+    if (done) return token;
+    token.time = time;
+    token.source = sources[sourceIndex];
+    token.offset = offset;
+    return token;
+}
+
+bool EdgeCursor::finished() const {
+    return done;
+}
@@ -0,0 +1,53 @@
+#ifndef TEMPUS_EDGE_CURSOR_H
+#define TEMPUS_EDGE_CURSOR_H
+
+#include <cstdint>
+#include <vector>
+#include "adj_list.h"
+
+/**
+ * Position of an EdgeCursor: the next edge it returns is destination number @p offset of @p source at @p time.
+ */
+struct CursorToken{
+    uint64_t time = 0;
+    uint64_t source = 0;
+    uint64_t offset = 0;
+    bool finished = false;
+};
+
+/**
+ * Pulls the edges of a time range one by one, ordered by time and, if requested, by source. Only the sources of the
+ * current timestamp and the destinations of the current source are held, so a window of any size is walked with
+ * bounded memory and the work stops as soon as the caller stops asking.
+ * The cursor reads the live graph, edges applied while it is open are seen if they lie ahead of its position.
+ * A token of a sorted cursor stays valid while the graph changes. Unsorted cursors visit the sources in table order,
+ * their tokens are only valid as long as the timestamp of the token is not modified.
+ */
+class EdgeCursor{
+public:
+    EdgeCursor(AdjList &graph, uint64_t start, uint64_t end, bool sortSources = true);
+    EdgeCursor(AdjList &graph, const CursorToken &token, uint64_t end, bool sortSources = true);
+    bool next(EdgeKey &edge);
+    size_t fetch(size_t limit, std::vector<EdgeKey> &out);
+    CursorToken token() const;
+    bool finished() const;
+
+private:
+    AdjList &graph;
+    uint64_t end;
+    bool sortSources;
+    bool done = false;
+
+    uint64_t time = 0;
+    std::vector<uint64_t> sources;
+    size_t sourceIndex = 0;
+    std::vector<uint64_t> destinations;
+    size_t offset = 0;
+
+    void seek(uint64_t from, const CursorToken *token);
+    void loadSources();
+    bool loadDestinations();
+    bool advance();
+};
+
+#endif //TEMPUS_EDGE_CURSOR_H
@@ -0,0 +1,101 @@
+#include "edge_export.h"
+
+/**
+ * @param path output file, an existing file is overwritten
+ * @param format
+ */
+EdgeWriter::EdgeWriter(const std::string &path, ExportFormat format)
+        : file(std::fopen(path.c_str(), "wb")), format(format) {
+    //the own buffer is written in one piece, so a failed write is reported by fwrite instead of a later fclose
+    if (file) std::setvbuf(file, nullptr, _IONBF, 0);
+    buffer.reserve(bufferSize);
+}
+
+EdgeWriter::~EdgeWriter() {
+    if (flush()) std::fclose(file);
+}
+
+/**
+ * @return false if the file could not be opened or a write failed
+ */
+bool EdgeWriter::isOpen() const {
+    return file != nullptr;
+}
+
+/**
+ * Appends one edge to the buffer and writes the buffer once it is full.
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param time timestamp of the edge
+ */
+void EdgeWriter::write(uint64_t source, uint64_t destination, uint64_t time) {
+    if (!file || source > destination) return;
+    //a text line has at most 4 + 3 * 20 + 3 characters
+    if (buffer.size() + 67 > bufferSize) flush();
+
+    if (format == ExportFormat::Binary) {
+        uint64_t record[3] = {source, destination, time};
+        const char *bytes = reinterpret_cast<const char*>(record);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(record));
+    } else {
+        buffer.insert(buffer.end(), {'a', 'd', 'd', ' '});
+        appendNumber(source);
+        buffer.push_back(' ');
+        appendNumber(destination);
+        buffer.push_back(' ');
+        appendNumber(time);
+        buffer.push_back('\n');
+    }
+    count++;
+}
+
+/**
+ * Writes all edges of @p partition, which are already in (source, destination) order.
+ * @param partition
+ */
+void EdgeWriter::writePartition(const FrozenPartition &partition) {
+    for (size_t j = 0; j < partition.sources.size(); j++) {
+        for (uint64_t k = partition.offsets[j]; k < partition.offsets[j + 1]; k++) {
+            write(partition.sources[j], partition.destinations[k], partition.time);
+        }
+    }
+}
+
+/**
+ * Appends the decimal digits of @p value, much faster than formatted stream output.
+ * @param value
+ */
+void EdgeWriter::appendNumber(uint64_t value) {
+    char digits[20];
+    int length = 0;
+    do {
+        digits[length++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (length > 0) buffer.push_back(digits[--length]);
+}
+
+/**
+ * Writes the buffer to the file. A short write closes the file, so isOpen reports the error and later writes are
+ * dropped.
+ * @return false if the buffer could not be written completely
+ */
+bool EdgeWriter::flush() {
+    if (!file) return false;
+    if (buffer.empty()) return true;
+    size_t written = std::fwrite(buffer.data(), 1, buffer.size(), file);
+    bool complete = written == buffer.size();
+    buffer.clear();
+    if (!complete) {
+        std::fclose(file);
+        file = nullptr;
+    }
+    return complete;
+}
+
+/**
+ * @return number of edges written so far
+ */
+uint64_t EdgeWriter::getCount() const {
+    return count;
+}
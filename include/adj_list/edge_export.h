@@ -0,0 +1,44 @@
+#ifndef TEMPUS_EDGE_EXPORT_H
+#define TEMPUS_EDGE_EXPORT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "snapshot.h"
+
+/**
+ * Text writes one "add source destination time" line per edge, the format read by addFromFile.
+ * Binary writes records of three uint64 values (source, destination, time) in native byte order, 24 bytes per edge.
+ */
+enum class ExportFormat{
+    Text,
+    Binary
+};
+
+/**
+ * Buffered writer for exported edges. The graph stores every undirected edge in both directions, only the direction
+ * with source <= destination is written, so replaying the file restores the graph without duplicates.
+ */
+class EdgeWriter{
+public:
+    EdgeWriter(const std::string &path, ExportFormat format);
+    ~EdgeWriter();
+    bool isOpen() const;
+    void write(uint64_t source, uint64_t destination, uint64_t time);
+    void writePartition(const FrozenPartition &partition);
+    bool flush();
+    uint64_t getCount() const;
+
+private:
+    static constexpr size_t bufferSize = 1 << 20;
+
+    FILE *file;
+    ExportFormat format;
+    std::vector<char> buffer;
+    uint64_t count = 0;
+
+    void appendNumber(uint64_t value);
+};
+
+#endif //TEMPUS_EDGE_EXPORT_H
@@ -0,0 +1,199 @@
+#include "ingestion_service.h"
+
+/**
+ * Starts the writer thread.
+ * @param graph graph the batches are applied to
+ * @param capacity maximum number of queued batches, rounded up to a power of two
+ * @param maxCoalescedEdges the writer stops merging batches once this many edges are collected
+ */
+IngestionService::IngestionService(AdjList &graph, size_t capacity, size_t maxCoalescedEdges)
+        : graph(graph), capacity(1), maxCoalescedEdges(maxCoalescedEdges) {
+    while (this->capacity < capacity) this->capacity <<= 1;
+    slots = std::make_unique<Slot[]>(this->capacity);
+    for (size_t i = 0; i < this->capacity; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+    writer = std::thread([this]() { run(); });
+}
+
+IngestionService::~IngestionService() {
+    stop();
+}
+
+/**
+ * Adds @p batch to the queue without blocking (bounded MPSC queue after Vyukov).
+ * @param batch edges to be applied, moved from only if the call succeeds
+ * @return false if the queue is full, the caller should back off and retry, or if the service was stopped
+ */
+bool IngestionService::tryEnqueue(EdgeBatch &&batch) {
+    activeProducers.fetch_add(1);
+    bool pushed = running.load() && tryPush(batch);
+    activeProducers.fetch_sub(1);
+    if (!pushed) rejectedEnqueues.fetch_add(1, std::memory_order_relaxed);
+    return pushed;
+}
+
+/**
+ * Adds @p batch to the queue and yields while the queue is full. A batch that had to wait or that came after stop
+ * counts as one rejection.
+ * @param batch edges to be applied, moved from only if the call succeeds
+ * @return false if the service was stopped before the batch was queued
+ */
+bool IngestionService::enqueue(EdgeBatch &&batch) {
+    activeProducers.fetch_add(1);
+    bool pushed = false;
+    bool waited = false;
+    while (running.load() && !(pushed = tryPush(batch))) {
+        waited = true;
+        std::this_thread::yield();
+    }
+    activeProducers.fetch_sub(1);
+    if (!pushed || waited) rejectedEnqueues.fetch_add(1, std::memory_order_relaxed);
+    return pushed;
+}
+
+/**
+ * @param batch moved into the queue if there is a free slot
+ * @return false if the queue is full
+ */
+bool IngestionService::tryPush(EdgeBatch &batch) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot &slot = slots[pos & (capacity - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (difference == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.batch = std::move(batch);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                break;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    enqueuedBatches.fetch_add(1, std::memory_order_relaxed);
+    uint64_t depth = pos + 1 - dequeuePos.load(std::memory_order_relaxed);
+    uint64_t maxDepth = maxQueueDepth.load(std::memory_order_relaxed);
+    while (depth > maxDepth && !maxQueueDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {}
+    wakeWriter();
+    return true;
+}
+
+/**
+ * Wakes the writer if it waits for batches. Producers only take the mutex when the writer announced that it waits:
+ * the fences order the published slot before reading the flag here and the flag before checking the queue in run, so
+ * either the writer sees the new batch or the producer sees the flag.
+ */
+void IngestionService::wakeWriter() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!writerWaiting.load(std::memory_order_relaxed)) return;
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wake.notify_one();
+}
+
+/**
+ * Only called by the writer thread.
+ * @return true if the next slot holds no batch
+ */
+bool IngestionService::queueEmpty() const {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    return slots[pos & (capacity - 1)].sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
+/**
+ * Only called by the writer thread.
+ * @param batch receives the oldest queued batch
+ * @return false if the queue is empty
+ */
+bool IngestionService::tryDequeue(EdgeBatch &batch) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Slot &slot = slots[pos & (capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+    batch = std::move(slot.batch);
+    slot.batch = EdgeBatch{};
+    slot.sequence.store(pos + capacity, std::memory_order_release);
+    dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * Writer loop. Merges consecutive batches of the same kind until maxCoalescedEdges is reached, so the order of
+ * insertions and deletions is preserved. After stop the writer only exits once no producer is inside an enqueue:
+ * producers announce themselves before they check running and stop clears running before the writer checks the
+ * producers, both sequentially consistent, so every batch that was accepted is also applied.
+ */
+void IngestionService::run() {
+    EdgeBatch pending;
+    bool hasPending = false;
+
+    while (true) {
+        if (!hasPending) hasPending = tryDequeue(pending);
+        if (!hasPending) {
+            if (!running.load() && activeProducers.load() == 0 &&
+                dequeuePos.load(std::memory_order_relaxed) == enqueuePos.load(std::memory_order_acquire)) break;
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            writerWaiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake.wait(lock, [&] { return !queueEmpty() || !running.load(std::memory_order_acquire); });
+            writerWaiting.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        EdgeBatch merged = std::move(pending);
+        hasPending = false;
+        uint64_t batches = 1;
+        while (merged.times.size() < maxCoalescedEdges && tryDequeue(pending)) {
+            if (pending.insert != merged.insert) {
+                hasPending = true;
+                break;
+            }
+            merged.sources.insert(merged.sources.end(), pending.sources.begin(), pending.sources.end());
+            merged.destinations.insert(merged.destinations.end(), pending.destinations.begin(), pending.destinations.end());
+            merged.times.insert(merged.times.end(), pending.times.begin(), pending.times.end());
+            batches++;
+        }
+
+        graph.applyBatch(merged.insert, merged.sources, merged.destinations, merged.times);
+        applyCalls.fetch_add(1, std::memory_order_relaxed);
+        appliedEdges.fetch_add(merged.times.size(), std::memory_order_relaxed);
+        appliedBatches.fetch_add(batches, std::memory_order_release);
+        { std::lock_guard<std::mutex> lock(wakeMutex); }
+        applied.notify_all();
+    }
+}
+
+/**
+ * Blocks until every batch that was enqueued before the call has been applied.
+ */
+void IngestionService::flush() {
+    uint64_t target = enqueuedBatches.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    applied.wait(lock, [&] { return appliedBatches.load(std::memory_order_acquire) >= target; });
+}
+
+/**
+ * Applies all queued batches and stops the writer thread, later enqueues are rejected.
+ */
+void IngestionService::stop() {
+    running.store(false);
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wake.notify_one();
+    if (writer.joinable()) writer.join();
+}
+
+/**
+ * @return current queue depth and counters since the service was started
+ */
+IngestionMetrics IngestionService::getMetrics() const {
+    IngestionMetrics metrics;
+    metrics.queueDepth = enqueuePos.load(std::memory_order_relaxed) - dequeuePos.load(std::memory_order_relaxed);
+    metrics.maxQueueDepth = maxQueueDepth.load(std::memory_order_relaxed);
+    metrics.enqueuedBatches = enqueuedBatches.load(std::memory_order_relaxed);
+    metrics.rejectedEnqueues = rejectedEnqueues.load(std::memory_order_relaxed);
+    metrics.appliedBatches = appliedBatches.load(std::memory_order_relaxed);
+    metrics.applyCalls = applyCalls.load(std::memory_order_relaxed);
+    metrics.appliedEdges = appliedEdges.load(std::memory_order_relaxed);
+    return metrics;
+}
@@ -0,0 +1,91 @@
+#ifndef TEMPUS_INGESTION_SERVICE_H
+#define TEMPUS_INGESTION_SERVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "adj_list.h"
+
+/**
+ * Edges that are inserted or deleted together, in the same layout as AdjList::applyBatch expects them.
+ */
+struct EdgeBatch{
+    bool insert = true;
+    std::vector<uint64_t> sources;
+    std::vector<uint64_t> destinations;
+    std::vector<uint64_t> times;
+};
+
+struct IngestionMetrics{
+    uint64_t queueDepth = 0;
+    uint64_t maxQueueDepth = 0;
+    uint64_t enqueuedBatches = 0;
+    uint64_t rejectedEnqueues = 0;
+    uint64_t appliedBatches = 0;
+    uint64_t applyCalls = 0;
+    uint64_t appliedEdges = 0;
+};
+
+/**
+ * Decouples producers from the graph. Producers put batches into a bounded lock free queue and return immediately,
+ * a single writer thread drains the queue and merges consecutive batches of the same kind into one
+ * AdjList::applyBatch call. The writer sleeps on a condition variable while the queue is empty.
+ * The writer is a plain thread outside of parlay's workers, and parlay runs the work of all such threads on the
+ * deque of worker 0. AdjList serializes its batches, so other threads may still apply batches to the same graph,
+ * but while the service is running no other thread may run parlay work of its own, e.g. window queries. Concurrent
+ * readers use AdjList::pinSnapshot, whose queries run on the calling thread.
+ */
+class IngestionService{
+public:
+    IngestionService(AdjList &graph, size_t capacity, size_t maxCoalescedEdges);
+    ~IngestionService();
+    bool tryEnqueue(EdgeBatch &&batch);
+    bool enqueue(EdgeBatch &&batch);
+    void flush();
+    void stop();
+    IngestionMetrics getMetrics() const;
+
+private:
+    struct Slot{
+        std::atomic<size_t> sequence;
+        EdgeBatch batch;
+    };
+
+    AdjList &graph;
+    size_t capacity;
+    size_t maxCoalescedEdges;
+    std::unique_ptr<Slot[]> slots;
+
+    //producers and the writer work on different ends of the queue, keep them on different cache lines
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+
+    std::atomic<bool> running{true};
+    //producers inside tryEnqueue or enqueue, the writer does not exit while one of them may still push
+    std::atomic<uint64_t> activeProducers{0};
+    std::atomic<uint64_t> maxQueueDepth{0};
+    std::atomic<uint64_t> enqueuedBatches{0};
+    //batches that found the queue full or came after stop, counted once per batch
+    std::atomic<uint64_t> rejectedEnqueues{0};
+    std::atomic<uint64_t> appliedBatches{0};
+    std::atomic<uint64_t> applyCalls{0};
+    std::atomic<uint64_t> appliedEdges{0};
+    //the writer waits on wake while the queue is empty, flush waits on applied
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable applied;
+    std::atomic<bool> writerWaiting{false};
+    std::thread writer;
+
+    bool tryPush(EdgeBatch &batch);
+    void wakeWriter();
+    bool queueEmpty() const;
+    bool tryDequeue(EdgeBatch &batch);
+    void run();
+};
+
+#endif //TEMPUS_INGESTION_SERVICE_H
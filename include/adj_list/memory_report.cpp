@@ -0,0 +1,36 @@
+#include "memory_report.h"
+
+#include <iostream>
+
+uint64_t MemoryReport::total() const {
+    return outerTable + innerTables + destinations + timestampIndex + vertexBitmaps + statistics + snapshot;
+}
+
+/**
+ * Adds the bytes of @p other to this report, used to combine the reports of several shards.
+ * @param other
+ */
+void MemoryReport::add(const MemoryReport &other) {
+    outerTable += other.outerTable;
+    innerTables += other.innerTables;
+    destinations += other.destinations;
+    timestampIndex += other.timestampIndex;
+    vertexBitmaps += other.vertexBitmaps;
+    statistics += other.statistics;
+    snapshot += other.snapshot;
+}
+
+/**
+ * Prints every part in bytes, in the same style as the timings of the batch operations.
+ */
+void MemoryReport::print() const {
+    std::cout << "Memory report in Bytes:" << std::endl;
+    std::cout << "    outer table: " << outerTable << std::endl;
+    std::cout << "    inner tables: " << innerTables << std::endl;
+    std::cout << "    destinations: " << destinations << std::endl;
+    std::cout << "    timestamp index: " << timestampIndex << std::endl;
+    std::cout << "    vertex bitmaps: " << vertexBitmaps << std::endl;
+    std::cout << "    statistics: " << statistics << std::endl;
+    std::cout << "    snapshot: " << snapshot << std::endl;
+    std::cout << "    total: " << total() << std::endl;
+}
@@ -0,0 +1,49 @@
+#ifndef TEMPUS_MEMORY_REPORT_H
+#define TEMPUS_MEMORY_REPORT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+/**
+ * Bytes held by the parts of a graph. Tables are measured by their allocated buckets and locks rather than by their
+ * entries, vectors by their capacity.
+ */
+struct MemoryReport{
+    //bucket and lock arrays of the timestamp table
+    uint64_t outerTable = 0;
+    //bucket and lock arrays of all per timestamp source tables
+    uint64_t innerTables = 0;
+    //allocated capacity of all destination vectors
+    uint64_t destinations = 0;
+    //nodes of the sorted timestamp set
+    uint64_t timestampIndex = 0;
+    //vertex bitmap table and the bitmaps themselves
+    uint64_t vertexBitmaps = 0;
+    //counter table and window prefix sums
+    uint64_t statistics = 0;
+    //partitions of the published snapshot, shared with every reader that pinned it
+    uint64_t snapshot = 0;
+
+    uint64_t total() const;
+    void add(const MemoryReport &other);
+    void print() const;
+};
+
+/**
+ * Allocated size of a libcuckoo table. Every bucket holds slot_per_bucket key value pairs together with a partial
+ * key byte and an occupied flag per slot, every lock is a cache line and there is one per bucket up to 2^16.
+ * Memory owned by the values and the map object itself is not included.
+ * @param map
+ * @return bytes of the table structure
+ */
+template<typename Map>
+uint64_t cuckooTableBytes(const Map &map) {
+    using Pair = std::pair<typename Map::key_type, typename Map::mapped_type>;
+    uint64_t bucket = Map::slot_per_bucket() * (sizeof(Pair) + sizeof(uint8_t) + sizeof(bool));
+    bucket = (bucket + alignof(Pair) - 1) / alignof(Pair) * alignof(Pair);
+    uint64_t locks = std::min<uint64_t>(map.bucket_count(), uint64_t(1) << 16);
+    return map.bucket_count() * bucket + locks * 64;
+}
+
+#endif //TEMPUS_MEMORY_REPORT_H
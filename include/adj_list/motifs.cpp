@@ -0,0 +1,256 @@
+#include "motifs.h"
+#include "triangles.h"
+#include "window_graph.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+uint64_t saturatingAdd(uint64_t a, uint64_t b) {
+    return a > std::numeric_limits<uint64_t>::max() - b ? std::numeric_limits<uint64_t>::max() : a + b;
+}
+
+uint64_t saturatingSub(uint64_t a, uint64_t b) {
+    return a < b ? 0 : a - b;
+}
+
+/**
+ * Events grouped by vertex in two orders that share the vertex offsets: by time, for the sliding windows of the
+ * stars and paths, and by neighbour and time, for the timestamps of one vertex pair.
+ */
+struct EventIndex{
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<uint64_t> offsets;
+    parlay::sequence<uint64_t> times;
+    parlay::sequence<uint64_t> neighbours;
+    parlay::sequence<uint64_t> pairNeighbours;
+    parlay::sequence<uint64_t> pairTimes;
+
+    explicit EventIndex(parlay::sequence<TemporalEvent> events) {
+        auto byTime = [](const TemporalEvent &a, const TemporalEvent &b) {
+            return std::tie(a.vertex, a.time, a.neighbour) < std::tie(b.vertex, b.time, b.neighbour);
+        };
+        parlay::sort_inplace(events, byTime);
+        events = parlay::unique(events, [](const TemporalEvent &a, const TemporalEvent &b) {
+            return a.vertex == b.vertex && a.time == b.time && a.neighbour == b.neighbour;
+        });
+        auto starts = parlay::pack_index(parlay::tabulate(events.size(), [&](size_t i) {
+            return i == 0 || events[i].vertex != events[i - 1].vertex;
+        }));
+        vertices = parlay::map(starts, [&](size_t i) { return events[i].vertex; });
+        offsets = parlay::tabulate(starts.size() + 1, [&](size_t i) -> uint64_t {
+            return i == starts.size() ? events.size() : starts[i];
+        });
+        times = parlay::map(events, [](const TemporalEvent &event) { return event.time; });
+        neighbours = parlay::map(events, [](const TemporalEvent &event) { return event.neighbour; });
+
+        parlay::sort_inplace(events, [](const TemporalEvent &a, const TemporalEvent &b) {
+            return std::tie(a.vertex, a.neighbour, a.time) < std::tie(b.vertex, b.neighbour, b.time);
+        });
+        pairNeighbours = parlay::map(events, [](const TemporalEvent &event) { return event.neighbour; });
+        pairTimes = parlay::map(events, [](const TemporalEvent &event) { return event.time; });
+    }
+
+    uint64_t indexOf(uint64_t vertex) const {
+        return std::lower_bound(vertices.begin(), vertices.end(), vertex) - vertices.begin();
+    }
+
+    //timestamps of the events between vertex index v and @p neighbour, ascending
+    std::pair<const uint64_t*, const uint64_t*> pairRange(uint64_t v, uint64_t neighbour) const {
+        auto begin = pairNeighbours.begin() + offsets[v];
+        auto end = pairNeighbours.begin() + offsets[v + 1];
+        auto range = std::equal_range(begin, end, neighbour);
+        return {pairTimes.data() + (range.first - pairNeighbours.begin()),
+                pairTimes.data() + (range.second - pairNeighbours.begin())};
+    }
+};
+
+/**
+ * Stars centered at vertex index v. Every event is the earliest event of the motifs it is counted for, the window
+ * holds the later events of at most δ after it, with a counter per neighbour and the sum of the neighbour pairs
+ * within the same counter. Ties are broken by the position in the time order.
+ */
+void countStars(const EventIndex &index, uint64_t v, uint64_t delta, TemporalMotifCounts &counts) {
+    std::unordered_map<uint64_t, uint64_t> inWindow;
+    uint64_t size = 0;
+    //pairs of window events with the same neighbour
+    uint64_t samePairs = 0;
+    uint64_t begin = index.offsets[v];
+    uint64_t end = index.offsets[v + 1];
+    uint64_t right = begin;
+
+    for (uint64_t i = begin; i < end; i++) {
+        if (right > i) {
+            uint64_t &count = inWindow[index.neighbours[i]];
+            count--;
+            samePairs -= count;
+            size--;
+        } else {
+            right = i + 1;
+        }
+        uint64_t last = saturatingAdd(index.times[i], delta);
+        while (right < end && index.times[right] <= last) {
+            uint64_t &count = inWindow[index.neighbours[right]];
+            samePairs += count;
+            count++;
+            size++;
+            right++;
+        }
+        uint64_t same = inWindow[index.neighbours[i]];
+        uint64_t others = size - same;
+        counts.repeatedEdges += same;
+        counts.twoEdgeStars += others;
+        counts.threeEdgeStars += others * (others - 1) / 2 - (samePairs - same * (same - 1) / 2);
+    }
+}
+
+/**
+ * Paths whose middle event lies on a static edge from vertex index b to a larger vertex c, so every path is counted
+ * once. A motif has all its events within δ of the middle event, so for every static edge only the time ranges of δ
+ * around its middle events are read, overlapping ranges are merged. The events of b (X, or M on the middle edge)
+ * and of c (Y, without the middle edge) in such a range are merged by time and swept with a window of δ like the
+ * stars, with counters per type and per ordered pair of types. Every event adds the pairs in the window that complete
+ * an X, M, Y triple with it. X and Y events on the same third vertex close a triangle instead, those triples are
+ * subtracted by the caller.
+ */
+void countPaths(const EventIndex &index, uint64_t b, uint64_t delta, TemporalMotifCounts &counts) {
+    enum Type { X, M, Y };
+    uint64_t vertexB = index.vertices[b];
+    auto times = index.times.begin();
+    std::vector<std::pair<uint64_t, Type>> sequence;
+
+    uint64_t run = index.offsets[b];
+    while (run < index.offsets[b + 1]) {
+        uint64_t vertexC = index.pairNeighbours[run];
+        uint64_t runEnd = run;
+        while (runEnd < index.offsets[b + 1] && index.pairNeighbours[runEnd] == vertexC) runEnd++;
+        if (vertexC < vertexB) {
+            run = runEnd;
+            continue;
+        }
+        uint64_t c = index.indexOf(vertexC);
+
+        for (uint64_t m = run; m < runEnd;) {
+            uint64_t from = saturatingSub(index.pairTimes[m], delta);
+            uint64_t to = saturatingAdd(index.pairTimes[m], delta);
+            for (m++; m < runEnd && saturatingSub(index.pairTimes[m], delta) <= to; m++) {
+                to = saturatingAdd(index.pairTimes[m], delta);
+            }
+
+            sequence.clear();
+            uint64_t x = std::lower_bound(times + index.offsets[b], times + index.offsets[b + 1], from) - times;
+            uint64_t xEnd = std::upper_bound(times + x, times + index.offsets[b + 1], to) - times;
+            uint64_t y = std::lower_bound(times + index.offsets[c], times + index.offsets[c + 1], from) - times;
+            uint64_t yEnd = std::upper_bound(times + y, times + index.offsets[c + 1], to) - times;
+            while (x < xEnd || y < yEnd) {
+                if (y == yEnd || (x < xEnd && index.times[x] <= index.times[y])) {
+                    sequence.emplace_back(index.times[x], index.neighbours[x] == vertexC ? M : X);
+                    x++;
+                } else {
+                    if (index.neighbours[y] != vertexB) sequence.emplace_back(index.times[y], Y);
+                    y++;
+                }
+            }
+
+            uint64_t single[3] = {};
+            //ordered pairs of window events by type, the first one is earlier
+            uint64_t pairs[3][3] = {};
+            size_t left = 0;
+            for (const auto &[time, type]: sequence) {
+                for (; saturatingAdd(sequence[left].first, delta) < time; left++) {
+                    Type leaving = sequence[left].second;
+                    single[leaving]--;
+                    for (int other = 0; other < 3; other++) pairs[leaving][other] -= single[other];
+                }
+                int first = (type + 1) % 3, second = (type + 2) % 3;
+                counts.threeEdgePaths += pairs[first][second] + pairs[second][first];
+                for (int other = 0; other < 3; other++) pairs[other][type] += single[other];
+                single[type]++;
+            }
+        }
+        run = runEnd;
+    }
+}
+
+/**
+ * Triples of one event per edge of a static triangle with timestamps within δ. Every event is taken as the earliest
+ * of its triples, ties are broken by the position of the lists.
+ */
+uint64_t countTriangleEvents(const std::pair<const uint64_t*, const uint64_t*> (&lists)[3], uint64_t delta) {
+    uint64_t triples = 0;
+    for (int k = 0; k < 3; k++) {
+        for (const uint64_t *time = lists[k].first; time != lists[k].second; time++) {
+            uint64_t product = 1;
+            for (int j = 0; j < 3 && product > 0; j++) {
+                if (j == k) continue;
+                const uint64_t *from = j > k ? std::lower_bound(lists[j].first, lists[j].second, *time)
+                                             : std::upper_bound(lists[j].first, lists[j].second, *time);
+                const uint64_t *to = std::upper_bound(lists[j].first, lists[j].second, saturatingAdd(*time, delta));
+                product *= to > from ? to - from : 0;
+            }
+            triples += product;
+        }
+    }
+    return triples;
+}
+
+}
+
+/**
+ * Counts all δ-temporal motifs of the given events. The events are grouped per vertex and ordered by time, stars
+ * are counted with a sliding window per vertex and paths around their middle event, both in parallel over the
+ * vertices. Triangles are enumerated on the static graph of the events and every one is expanded into the triples
+ * of its events within δ.
+ * @param events both directions of every undirected edge at every timestamp, without self loops
+ * @param delta largest difference between the timestamps of the events of one motif
+ * @return number of motifs per type
+ */
+TemporalMotifCounts countTemporalMotifs(parlay::sequence<TemporalEvent> events, uint64_t delta) {
+    EventIndex index(std::move(events));
+    size_t n = index.vertices.size();
+
+    auto perVertex = parlay::tabulate(n, [&](size_t v) {
+        TemporalMotifCounts counts;
+        countStars(index, v, delta, counts);
+        countPaths(index, v, delta, counts);
+        return counts;
+    }, 1);
+    TemporalMotifCounts counts;
+    //every repeated edge is seen from both of its vertices
+    counts.repeatedEdges = parlay::reduce(parlay::delayed_map(perVertex, [](const TemporalMotifCounts &c) {
+        return c.repeatedEdges;
+    })) / 2;
+    counts.twoEdgeStars = parlay::reduce(parlay::delayed_map(perVertex, [](const TemporalMotifCounts &c) {
+        return c.twoEdgeStars;
+    }));
+    counts.threeEdgeStars = parlay::reduce(parlay::delayed_map(perVertex, [](const TemporalMotifCounts &c) {
+        return c.threeEdgeStars;
+    }));
+    //paths are counted with the triples that close a triangle, which are subtracted once triangles are known
+    uint64_t openPaths = parlay::reduce(parlay::delayed_map(perVertex, [](const TemporalMotifCounts &c) {
+        return c.threeEdgePaths;
+    }));
+
+    auto pairs = parlay::filter(parlay::tabulate(index.pairNeighbours.size(), [&](size_t i) {
+        uint64_t v = std::upper_bound(index.offsets.begin(), index.offsets.end(), i) - index.offsets.begin() - 1;
+        return std::make_pair(index.vertices[v], index.pairNeighbours[i]);
+    }), [](const std::pair<uint64_t, uint64_t> &pair) { return pair.first < pair.second; });
+    WindowGraph graph(index.vertices, parlay::unique(pairs));
+    counts.triangles = sumOverTriangles(graph, [&](uint64_t u, uint64_t v, uint64_t w) {
+        std::pair<const uint64_t*, const uint64_t*> lists[3] = {
+                index.pairRange(u, index.vertices[v]),
+                index.pairRange(v, index.vertices[w]),
+                index.pairRange(u, index.vertices[w])
+        };
+        return countTriangleEvents(lists, delta);
+    });
+    //every triangle triple was counted once with each of its edges as middle edge
+    counts.threeEdgePaths = openPaths - 3 * counts.triangles;
+    return counts;
+}
@@ -0,0 +1,35 @@
+#ifndef TEMPUS_MOTIFS_H
+#define TEMPUS_MOTIFS_H
+
+#include <cstdint>
+#include "parlay/sequence.h"
+
+/**
+ * One direction of an undirected edge at one timestamp.
+ */
+struct TemporalEvent{
+    uint64_t vertex;
+    uint64_t time;
+    uint64_t neighbour;
+};
+
+/**
+ * Numbers of δ-temporal motifs. An event is an undirected edge at one timestamp, a motif is a set of events whose
+ * timestamps differ by at most δ. Events on the same vertex pair at different timestamps are different events.
+ */
+struct TemporalMotifCounts{
+    //two events on the same vertex pair
+    uint64_t repeatedEdges = 0;
+    //two events that share exactly one vertex, for undirected edges the 2 edge star and the 2 edge path
+    uint64_t twoEdgeStars = 0;
+    //three events from one center to three distinct vertices
+    uint64_t threeEdgeStars = 0;
+    //three events that form a path over four distinct vertices
+    uint64_t threeEdgePaths = 0;
+    //three events that form a triangle
+    uint64_t triangles = 0;
+};
+
+TemporalMotifCounts countTemporalMotifs(parlay::sequence<TemporalEvent> events, uint64_t delta);
+
+#endif //TEMPUS_MOTIFS_H
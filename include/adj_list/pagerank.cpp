@@ -0,0 +1,116 @@
+#include "pagerank.h"
+#include "adj_list.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @param vertex
+ * @return rank of @p vertex, 0 if it has no edge in the window
+ */
+double PageRankResult::rankOf(uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return 0;
+    return ranks[it - vertices.begin()];
+}
+
+/**
+ * Power iteration as a parallel sparse matrix vector product over the CSR graph. Every vertex pulls the rank its
+ * neighbours split among their edges, long neighbour lists are summed with a parallel reduce. The rank of vertices
+ * without neighbours is handed to the restart vertices, so the ranks keep summing up to 1.
+ * @param graph window to rank
+ * @param options
+ * @param warmStart ranks to start from, vertices missing in it start with their restart probability. Without it the
+ * iteration starts from the restart distribution
+ * @return ranks of all vertices of @p graph
+ */
+PageRankResult computePageRank(const WindowGraph &graph, const PageRankOptions &options,
+                               const PageRankResult *warmStart) {
+    PageRankResult result;
+    result.vertices = graph.getVertices();
+    size_t n = graph.numVertices();
+    if (n == 0) return result;
+    double damping = options.damping;
+
+    parlay::sequence<double> restart(n, 1.0 / n);
+    auto seeds = parlay::filter(parlay::map(parlay::to_sequence(options.personalization), [&](uint64_t vertex) {
+        return graph.indexOf(vertex);
+    }), [](uint64_t index) { return index != std::numeric_limits<uint64_t>::max(); });
+    parlay::sort_inplace(seeds);
+    seeds = parlay::unique(seeds);
+    if (!seeds.empty()) {
+        restart = parlay::sequence<double>(n, 0.0);
+        for (uint64_t seed: seeds) restart[seed] = 1.0 / seeds.size();
+    }
+
+    parlay::sequence<double> ranks = restart;
+    if (warmStart != nullptr) {
+        ranks = parlay::tabulate(n, [&](size_t i) {
+            auto it = std::lower_bound(warmStart->vertices.begin(), warmStart->vertices.end(), graph.vertexId(i));
+            if (it == warmStart->vertices.end() || *it != graph.vertexId(i)) return restart[i];
+            return warmStart->ranks[it - warmStart->vertices.begin()];
+        });
+        double sum = parlay::reduce(ranks);
+        if (sum > 0) parlay::parallel_for(0, n, [&](size_t i) { ranks[i] /= sum; });
+        else ranks = restart;
+    }
+    auto inverseDegree = parlay::tabulate(n, [&](size_t i) {
+        return graph.degree(i) == 0 ? 0.0 : 1.0 / graph.degree(i);
+    });
+
+    while (result.iterations < options.maxIterations) {
+        double dangling = parlay::reduce(parlay::delayed_tabulate(n, [&](size_t i) {
+            return graph.degree(i) == 0 ? ranks[i] : 0.0;
+        }));
+        auto shares = parlay::tabulate(n, [&](size_t i) { return ranks[i] * inverseDegree[i]; });
+        auto next = parlay::tabulate(n, [&](size_t v) {
+            auto neighbours = graph.neighbours(v);
+            double pulled = 0;
+            if (neighbours.size() < 100) {
+                for (uint64_t u: neighbours) pulled += shares[u];
+            } else {
+                pulled = parlay::reduce(parlay::delayed_map(neighbours, [&](uint64_t u) { return shares[u]; }));
+            }
+            return (1 - damping) * restart[v] + damping * (pulled + dangling * restart[v]);
+        }, 100);
+        result.delta = parlay::reduce(parlay::delayed_tabulate(n, [&](size_t i) {
+            return std::fabs(next[i] - ranks[i]);
+        }));
+        ranks = std::move(next);
+        result.iterations++;
+        if (result.delta < options.tolerance) break;
+    }
+    result.ranks = std::move(ranks);
+    return result;
+}
+
+WindowedPageRank::WindowedPageRank(PageRankOptions options) : options(std::move(options)) {}
+
+/**
+ * Ranks the window [@p start, @p end), starting from the ranks of the previous call.
+ * @param graph
+ * @param start of the window inclusive
+ * @param end of the window exclusive
+ * @return ranks of the window, valid until the next call
+ */
+const PageRankResult &WindowedPageRank::slideTo(AdjList &graph, uint64_t start, uint64_t end) {
+    PageRankResult next = computePageRank(graph.getWindowGraph(start, end), options, warm ? &result : nullptr);
+    result = std::move(next);
+    warm = true;
+    return result;
+}
+
+const PageRankResult &WindowedPageRank::getResult() const {
+    return result;
+}
+
+/**
+ * Forgets the previous ranks, the next window starts from the restart distribution again.
+ */
+void WindowedPageRank::reset() {
+    result = PageRankResult();
+    warm = false;
+}
@@ -0,0 +1,53 @@
+#ifndef TEMPUS_PAGERANK_H
+#define TEMPUS_PAGERANK_H
+
+#include <cstdint>
+#include <vector>
+#include "parlay/sequence.h"
+#include "window_graph.h"
+
+class AdjList;
+
+struct PageRankOptions{
+    double damping = 0.85;
+    //iterations stop once the L1 distance between two rank vectors drops below this
+    double tolerance = 1e-9;
+    uint64_t maxIterations = 100;
+    //vertices the random walk restarts at, empty restarts uniformly at all vertices
+    std::vector<uint64_t> personalization;
+};
+
+/**
+ * Ranks of the vertices of a window, @p ranks[i] belongs to @p vertices[i] and the ranks sum up to 1.
+ */
+struct PageRankResult{
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<double> ranks;
+    uint64_t iterations = 0;
+    //L1 distance of the last iteration
+    double delta = 0;
+
+    double rankOf(uint64_t vertex) const;
+};
+
+PageRankResult computePageRank(const WindowGraph &graph, const PageRankOptions &options,
+                               const PageRankResult *warmStart = nullptr);
+
+/**
+ * PageRank of a sliding window. Every window starts from the ranks of the previous one, consecutive windows share
+ * most of their edges, so only a few iterations are needed until the ranks converge again.
+ */
+class WindowedPageRank{
+public:
+    explicit WindowedPageRank(PageRankOptions options);
+    const PageRankResult &slideTo(AdjList &graph, uint64_t start, uint64_t end);
+    const PageRankResult &getResult() const;
+    void reset();
+
+private:
+    PageRankOptions options;
+    PageRankResult result;
+    bool warm = false;
+};
+
+#endif //TEMPUS_PAGERANK_H
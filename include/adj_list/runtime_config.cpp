@@ -0,0 +1,197 @@
+#include "runtime_config.h"
+#include "parlay/parallel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    SchedulerConfig activeConfig;
+    std::mutex configMutex;
+    //set once configureScheduler has started parlay's scheduler, PARLAY_NUM_THREADS is not read again afterwards
+    bool schedulerStarted = false;
+    //node of the cpu every worker is pinned to, empty if the workers are not pinned
+    std::vector<int> workerNodes;
+
+    /**
+     * Parses a sysfs cpu list like "0-3,8,10-11".
+     * @param list
+     * @return all cpus in @p list
+     */
+    std::vector<int> parseCpuList(const std::string &list) {
+        std::vector<int> cpus;
+        std::stringstream stream(list);
+        std::string range;
+        while (std::getline(stream, range, ',')) {
+            if (range.empty() || range == "\n") continue;
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    bool envFlag(const char *name) {
+        const char *value = std::getenv(name);
+        return value && std::string(value) != "0" && std::string(value) != "false";
+    }
+}
+
+/**
+ * Reads TEMPUS_NUM_THREADS, TEMPUS_PIN_THREADS and TEMPUS_NUMA_FIRST_TOUCH.
+ * @return configuration described by the environment
+ */
+SchedulerConfig SchedulerConfig::fromEnvironment() {
+    SchedulerConfig config;
+    if (const char *workers = std::getenv("TEMPUS_NUM_THREADS")) config.workers = std::strtoul(workers, nullptr, 10);
+    config.pinThreads = envFlag("TEMPUS_PIN_THREADS");
+    config.numaFirstTouch = envFlag("TEMPUS_NUMA_FIRST_TOUCH");
+    return config;
+}
+
+/**
+ * Lists the cpus of every NUMA node as reported by sysfs. Machines without NUMA information are treated as one node.
+ * @return cpus per node
+ */
+std::vector<std::vector<int>> numaNodes() {
+    std::vector<std::vector<int>> nodes;
+    for (int node = 0;; node++) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file.is_open()) break;
+        std::string list;
+        std::getline(file, list);
+        nodes.push_back(parseCpuList(list));
+    }
+    if (nodes.empty()) {
+        nodes.emplace_back();
+        for (int cpu = 0; cpu < static_cast<int>(std::thread::hardware_concurrency()); cpu++) nodes[0].push_back(cpu);
+    }
+    return nodes;
+}
+
+/**
+ * Runs @p f at most once for every parlay worker id, on that worker. Rounds of one task per worker are started until
+ * every worker ran its job or a second has passed, every task stays busy for a moment so that the other tasks of its
+ * round are taken by other workers, and the repeated rounds wake up workers that sleep. Workers that could not be
+ * reached (e.g. because they are busy in an enclosing parallel loop) are skipped, running their job on another thread
+ * would give it the wrong cpu and memory node.
+ * @param f called with the worker id
+ * @return ids of the workers @p f did not run for, sorted
+ */
+std::vector<size_t> runOnEachWorker(const std::function<void(size_t)> &f) {
+    size_t workers = parlay::num_workers();
+    std::atomic<size_t> remaining{workers};
+    std::vector<std::atomic<bool>> done(workers);
+    for (auto &flag: done) flag = false;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    do {
+        parlay::parallel_for(0, workers, [&](size_t) {
+            size_t id = parlay::worker_id();
+            if (!done[id].exchange(true)) {
+                f(id);
+                remaining--;
+            }
+            auto busyUntil = std::chrono::steady_clock::now() + std::chrono::microseconds(100);
+            while (remaining.load() > 0 && std::chrono::steady_clock::now() < busyUntil) std::this_thread::yield();
+        }, 1);
+    } while (remaining.load() > 0 && std::chrono::steady_clock::now() < deadline);
+
+    std::vector<size_t> unreached;
+    for (size_t id = 0; id < workers; id++) {
+        if (!done[id].load()) unreached.push_back(id);
+    }
+    return unreached;
+}
+
+/**
+ * Applies @p config to parlay's scheduler. The worker count is passed on through PARLAY_NUM_THREADS, which parlay
+ * reads once when its scheduler starts, so it has to be called from the main thread before any parallel code runs
+ * and before other threads that could read the environment exist. Only the first call sets the variable, a later
+ * call or one after parlay was already used reports a differing worker count instead of silently ignoring it.
+ * Pinned workers are placed compactly, filling one node before the next.
+ * @param config
+ * @return false if the scheduler was already running with a different number of workers or a worker could not be
+ * pinned, unpinned workers report node -1
+ */
+bool configureScheduler(const SchedulerConfig &config) {
+    std::lock_guard<std::mutex> guard(configMutex);
+    if (config.workers > 0 && !schedulerStarted) {
+        setenv("PARLAY_NUM_THREADS", std::to_string(config.workers).c_str(), 1);
+    }
+    activeConfig = config;
+    size_t workers = parlay::num_workers();
+    schedulerStarted = true;
+    if (config.workers > 0 && config.workers != workers) {
+        std::cout << "configureScheduler: parlay already runs " << workers << " workers, " << config.workers
+                  << " requested workers are ignored" << std::endl;
+    }
+
+    workerNodes.clear();
+    bool pinned = true;
+    if (config.pinThreads) {
+        std::vector<std::pair<int, int>> cpus;
+        auto nodes = numaNodes();
+        for (size_t node = 0; node < nodes.size(); node++) {
+            for (int cpu: nodes[node]) cpus.emplace_back(cpu, static_cast<int>(node));
+        }
+        workerNodes.assign(workers, -1);
+        auto unreached = runOnEachWorker([&](size_t worker) {
+            auto [cpu, node] = cpus[worker % cpus.size()];
+            workerNodes[worker] = node;
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+        });
+        pinned = unreached.empty();
+    }
+    activeConfig.workers = workers;
+    return pinned && (config.workers == 0 || config.workers == workers);
+}
+
+const SchedulerConfig &schedulerConfig() {
+    return activeConfig;
+}
+
+/**
+ * @param worker parlay worker id
+ * @return NUMA node the worker is pinned to, -1 if it is not pinned
+ */
+int numaNodeOfWorker(size_t worker) {
+    if (worker >= workerNodes.size()) return -1;
+    return workerNodes[worker];
+}
+
+/**
+ * Prints the number of workers and, if they are pinned, how many run on each node.
+ */
+void printSchedulerConfig() {
+    std::cout << "Scheduler workers: " << parlay::num_workers() << ", pinned: " << activeConfig.pinThreads
+              << ", NUMA first touch: " << activeConfig.numaFirstTouch << std::endl;
+    if (workerNodes.empty()) return;
+    std::vector<size_t> perNode(numaNodes().size(), 0);
+    size_t unpinned = 0;
+    for (int node: workerNodes) {
+        if (node < 0) unpinned++;
+        else perNode[node]++;
+    }
+    for (size_t node = 0; node < perNode.size(); node++) {
+        std::cout << "    node " << node << ": " << perNode[node] << " workers" << std::endl;
+    }
+    if (unpinned > 0) std::cout << "    unpinned: " << unpinned << " workers" << std::endl;
+}
@@ -0,0 +1,29 @@
+#ifndef TEMPUS_RUNTIME_CONFIG_H
+#define TEMPUS_RUNTIME_CONFIG_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * Settings for parlay's global scheduler. They have to be applied with configureScheduler before the first parallel
+ * call, because parlay starts its workers only once.
+ */
+struct SchedulerConfig{
+    //0 keeps parlay's default (PARLAY_NUM_THREADS or all hardware threads)
+    size_t workers = 0;
+    bool pinThreads = false;
+    //ShardedAdjList allocates and applies every shard on the worker that owns it, so its memory stays on that node
+    bool numaFirstTouch = false;
+
+    static SchedulerConfig fromEnvironment();
+};
+
+bool configureScheduler(const SchedulerConfig &config);
+const SchedulerConfig &schedulerConfig();
+std::vector<std::vector<int>> numaNodes();
+int numaNodeOfWorker(size_t worker);
+std::vector<size_t> runOnEachWorker(const std::function<void(size_t)> &f);
+void printSchedulerConfig();
+
+#endif //TEMPUS_RUNTIME_CONFIG_H
@@ -0,0 +1,253 @@
+#include "sharded_adj_list.h"
+#include "runtime_config.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <set>
+#include <tuple>
+
+/**
+ * @param vertexShards number of partitions of the vertex id space
+ * @param epochShards number of partitions of the time axis, epochs are assigned round robin
+ * @param epochLength number of time units that form one epoch
+ */
+ShardedAdjList::ShardedAdjList(size_t vertexShards, size_t epochShards, uint64_t epochLength)
+        : vertexShards(std::max<size_t>(vertexShards, 1)), epochShards(std::max<size_t>(epochShards, 1)),
+          epochLength(std::max<uint64_t>(epochLength, 1)) {
+    shards.resize(this->vertexShards * this->epochShards);
+    if (schedulerConfig().numaFirstTouch) {
+        //every worker allocates the shards it owns once, so their tables are placed on its node
+        size_t workers = parlay::num_workers();
+        runOnEachWorker([&](size_t worker) {
+            for (size_t i = worker; i < shards.size(); i += workers) shards[i] = std::make_unique<AdjList>();
+        });
+    }
+    //shards of unreached workers are allocated by the caller
+    for (auto &shard: shards) {
+        if (!shard) shard = std::make_unique<AdjList>();
+    }
+}
+
+/**
+ * @param vertex source node of a directed edge
+ * @param time timestamp of the edge
+ * @return index of the shard that stores the edge
+ */
+size_t ShardedAdjList::shardOf(uint64_t vertex, uint64_t time) const {
+    size_t vertexShard = parlay::hash64(vertex) % vertexShards;
+    size_t epochShard = (time / epochLength) % epochShards;
+    return vertexShard * epochShards + epochShard;
+}
+
+size_t ShardedAdjList::shardCount() const {
+    return shards.size();
+}
+
+/**
+ * Reads the same format as AdjList::addFromFile and applies all additions, then all deletions.
+ * @param path input file
+ */
+void ShardedAdjList::addFromFile(const std::string &path) {
+    std::ifstream file(path);
+    if (file.is_open()) {
+        std::string command;
+        uint64_t source, destination, time;
+        std::vector<uint64_t> sourceAdds{}, destinationAdds{}, timeAdds{};
+        std::vector<uint64_t> sourceDels{}, destinationDels{}, timeDels{};
+
+        while (file >> command >> source >> destination >> time) {
+            if (command == "add") {
+                sourceAdds.push_back(source);
+                destinationAdds.push_back(destination);
+                timeAdds.push_back(time);
+            }
+            if (command == "delete") {
+                sourceDels.push_back(source);
+                destinationDels.push_back(destination);
+                timeDels.push_back(time);
+            }
+        }
+        file.close();
+
+        batchOperation(true, sourceAdds, destinationAdds, timeAdds);
+        batchOperation(false, sourceDels, destinationDels, timeDels);
+    }
+}
+
+/**
+ * Splits every undirected edge into its two directions, routes them to their shards with a parallel counting sort
+ * and then applies all shards in parallel. Inside a shard the edges are sorted by time so that every partition is
+ * touched in one run. With NUMA first touch every shard is applied by the worker that allocated it, like in the
+ * constructor, and the shards of workers that could not be reached by the caller.
+ * @param insert dictates whether to insert or delete the given edges
+ * @param sources list of source nodes
+ * @param destinations list of destination nodes
+ * @param times list of timestamps
+ */
+void ShardedAdjList::batchOperation(bool insert, const std::vector<uint64_t> &sources,
+                                    const std::vector<uint64_t> &destinations, const std::vector<uint64_t> &times) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    using HalfEdge = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+    auto halfEdges = parlay::tabulate(2 * times.size(), [&](size_t i) {
+        size_t j = i / 2;
+        if (i % 2 == 0) return HalfEdge{times[j], sources[j], destinations[j]};
+        return HalfEdge{times[j], destinations[j], sources[j]};
+    });
+    auto [routed, offsets] = parlay::counting_sort(halfEdges, shards.size(), [&](const HalfEdge &e) {
+        return shardOf(std::get<1>(e), std::get<0>(e));
+    });
+
+    auto applyShard = [&](size_t i) {
+        auto shardEdges = routed.cut(offsets[i], offsets[i + 1]);
+        if (shardEdges.size() == 0) return;
+        parlay::sort_inplace(shardEdges);
+        AdjList &shard = *shards[i];
+
+        if (insert) {
+            std::lock_guard<std::mutex> guard(shard.timestampsMutex);
+            for (size_t j = 0; j < shardEdges.size(); j++) {
+                if (j == 0 || std::get<0>(shardEdges[j]) != std::get<0>(shardEdges[j - 1])) {
+                    shard.uniqueTimestamps.insert(std::get<0>(shardEdges[j]));
+                }
+            }
+        }
+        for (const auto &[time, source, destination]: shardEdges) {
+            shard.applyDirected(insert, source, destination, time);
+        }
+        shard.rebuildStatsIndex();
+    };
+    if (schedulerConfig().numaFirstTouch) {
+        //a shard grows on the worker that allocated it, so rehashes and new partitions stay on its node
+        size_t workers = parlay::num_workers();
+        auto unreached = runOnEachWorker([&](size_t worker) {
+            for (size_t i = worker; i < shards.size(); i += workers) applyShard(i);
+        });
+        for (size_t worker: unreached) {
+            for (size_t i = worker; i < shards.size(); i += workers) applyShard(i);
+        }
+    } else {
+        parlay::parallel_for(0, shards.size(), applyShard, 1);
+    }
+
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto ms_int = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+    std::cout << "shardedBatchOperation has taken " << ms_int.count() << "ms\n";
+}
+
+/**
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param time timestamp of the edge
+ * @return true if the edge was found
+ */
+bool ShardedAdjList::findEdge(uint64_t source, uint64_t destination, uint64_t time) {
+    return shards[shardOf(source, time)]->findEdge(source, destination, time);
+}
+
+/**
+ * Sums up the edge counts of all shards that belong to the epoch of @p timestamp.
+ * @param timestamp
+ * @return number of directed edges at @p timestamp
+ */
+size_t ShardedAdjList::getEdgeCount(uint64_t timestamp) {
+    size_t epochShard = (timestamp / epochLength) % epochShards;
+    size_t count = 0;
+    for (size_t v = 0; v < vertexShards; v++) {
+        count += shards[v * epochShards + epochShard]->getEdgeCount(timestamp);
+    }
+    return count;
+}
+
+/**
+ * Sums up the window counters of all shards.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return summed counters of the range
+ */
+TimestampStats ShardedAdjList::getWindowStats(uint64_t start, uint64_t end) const {
+    TimestampStats stats;
+    for (const auto &shard: shards) {
+        TimestampStats shardStats = shard->getWindowStats(start, end);
+        stats.edges += shardStats.edges;
+        stats.sources += shardStats.sources;
+        stats.bytes += shardStats.bytes;
+    }
+    return stats;
+}
+
+/**
+ * @return summed memory reports of all shards
+ */
+MemoryReport ShardedAdjList::getMemoryReport() {
+    MemoryReport report;
+    for (const auto &shard: shards) report.add(shard->getMemoryReport());
+    return report;
+}
+
+/**
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @return bitmap of all vertices that have an edge within the time range
+ */
+VertexBitmap ShardedAdjList::getVertexBitmap(uint64_t start, uint64_t end) {
+    auto bitmaps = parlay::map(shards, [&](const std::unique_ptr<AdjList> &shard) {
+        return shard->getVertexBitmap(start, end);
+    }, 1);
+    std::vector<const VertexBitmap*> pointers;
+    for (const auto &b: bitmaps) pointers.push_back(&b);
+    return VertexBitmap::unionAll(pointers);
+}
+
+/**
+ * Writes all edges of the given range in (time, source, destination) order. For every timestamp the vertex shards of
+ * its epoch are frozen in parallel and their sorted sources are merged with a heap, so only one timestamp is held in
+ * memory at a time.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @param path output file
+ * @param format
+ * @return number of written edges, 0 if the file could not be opened or written
+ */
+uint64_t ShardedAdjList::exportRange(uint64_t start, uint64_t end, const std::string &path, ExportFormat format) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    EdgeWriter writer(path, format);
+    if (!writer.isOpen()) return 0;
+
+    std::set<uint64_t> times;
+    for (const auto &shard: shards) {
+        auto shardTimes = shard->timesInRange(start, end);
+        times.insert(shardTimes.begin(), shardTimes.end());
+    }
+
+    //(source, shard, position of the source in its partition)
+    using Head = std::tuple<uint64_t, size_t, size_t>;
+    for (uint64_t time: times) {
+        size_t epochShard = (time / epochLength) % epochShards;
+        auto partitions = parlay::tabulate(vertexShards, [&](size_t v) {
+            return shards[v * epochShards + epochShard]->freezePartition(time);
+        }, 1);
+
+        std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+        for (size_t v = 0; v < vertexShards; v++) {
+            if (partitions[v] && !partitions[v]->sources.empty()) heads.emplace(partitions[v]->sources[0], v, 0);
+        }
+        while (!heads.empty()) {
+            auto [source, v, j] = heads.top();
+            heads.pop();
+            const FrozenPartition &p = *partitions[v];
+            for (uint64_t k = p.offsets[j]; k < p.offsets[j + 1]; k++) writer.write(source, p.destinations[k], time);
+            if (j + 1 < p.sources.size()) heads.emplace(p.sources[j + 1], v, j + 1);
+        }
+    }
+    if (!writer.flush()) return 0;
+
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto ms_int = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+    std::cout << "shardedExportRange has taken " << ms_int.count() << "ms\n";
+    return writer.getCount();
+}
@@ -0,0 +1,35 @@
+#ifndef TEMPUS_SHARDED_ADJ_LIST_H
+#define TEMPUS_SHARDED_ADJ_LIST_H
+
+#include <memory>
+#include <vector>
+#include "adj_list.h"
+
+/**
+ * AdjList split into independent shards by (source vertex hash, time epoch). Every direction of an edge lives in the
+ * shard of its source, so a batch can be applied shard parallel without two threads touching the same outer map.
+ */
+class ShardedAdjList{
+public:
+    ShardedAdjList(size_t vertexShards, size_t epochShards, uint64_t epochLength);
+    void addFromFile(const std::string& path);
+    void batchOperation(bool insert, const std::vector<uint64_t> &sources, const std::vector<uint64_t> &destinations,
+                        const std::vector<uint64_t> &times);
+    bool findEdge(uint64_t source, uint64_t destination, uint64_t time);
+    size_t getEdgeCount(uint64_t timestamp);
+    TimestampStats getWindowStats(uint64_t start, uint64_t end) const;
+    MemoryReport getMemoryReport();
+    VertexBitmap getVertexBitmap(uint64_t start, uint64_t end);
+    uint64_t exportRange(uint64_t start, uint64_t end, const std::string &path, ExportFormat format);
+    size_t shardCount() const;
+
+private:
+    size_t vertexShards;
+    size_t epochShards;
+    uint64_t epochLength;
+    std::vector<std::unique_ptr<AdjList>> shards;
+
+    size_t shardOf(uint64_t vertex, uint64_t time) const;
+};
+
+#endif //TEMPUS_SHARDED_ADJ_LIST_H
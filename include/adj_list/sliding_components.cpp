@@ -0,0 +1,267 @@
+#include "sliding_components.h"
+#include "edge_cursor.h"
+
+#include <algorithm>
+
+/**
+ * @param window number of most recent timestamps that form the window
+ */
+SlidingWindowComponents::SlidingWindowComponents(uint64_t window) : window(std::max<uint64_t>(window, 1)) {}
+
+/**
+ * Moves the window to [end - window, end). Expired edges are cut first, afterwards the timestamps that entered the
+ * window are read from @p graph in ascending order.
+ * @param graph graph the edges are read from
+ * @param end of the window exclusive, must not be smaller than in the previous call
+ */
+void SlidingWindowComponents::slideTo(AdjList &graph, uint64_t end) {
+    uint64_t start = end > window ? end - window : 0;
+    expireBefore(start);
+
+    EdgeCursor cursor(graph, std::max(this->end, start), end, false);
+    EdgeKey edge{};
+    while (cursor.next(edge)) {
+        //every edge is stored in both directions, one of them is enough
+        if (edge.source <= edge.destination) addEdge(edge.source, edge.destination, edge.time);
+    }
+    this->end = std::max(this->end, end);
+}
+
+/**
+ * Adds one edge to the window. If it connects two trees it becomes a forest edge, otherwise it replaces the oldest
+ * edge on the cycle it closes, as long as that one is older.
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param time timestamp of the edge, not smaller than the timestamps added before
+ */
+void SlidingWindowComponents::addEdge(uint64_t source, uint64_t destination, uint64_t time) {
+    size_t a = vertexNode(source);
+    size_t b = vertexNode(destination);
+    uint64_t sequence = firstSequence + edges.size();
+    edges.push_back({time, a, b, nil});
+    if (degrees[a]++ == 0) activeVertices++;
+    if (a == b) return;
+    if (degrees[b]++ == 0) activeVertices++;
+
+    if (findRoot(a) == findRoot(b)) {
+        makeRoot(a);
+        access(b);
+        size_t oldest = nodes[b].minimum;
+        if (nodes[oldest].value >= time) return;
+        edges[nodes[oldest].sequence - firstSequence].treeNode = nil;
+        removeTreeEdge(oldest);
+    }
+    size_t e = newEdgeNode(time, sequence, a, b);
+    link(a, e);
+    link(e, b);
+    edges.back().treeNode = e;
+    treeEdges++;
+}
+
+/**
+ * Removes all edges older than @p start. Forest edges are cut, the oldest edges are at the front of the window.
+ * @param start oldest timestamp that is kept
+ */
+void SlidingWindowComponents::expireBefore(uint64_t start) {
+    while (!edges.empty() && edges.front().time < start) {
+        const WindowEdge &edge = edges.front();
+        if (edge.treeNode != nil) removeTreeEdge(edge.treeNode);
+        if (--degrees[edge.source] == 0) activeVertices--;
+        if (edge.destination != edge.source && --degrees[edge.destination] == 0) activeVertices--;
+        edges.pop_front();
+        firstSequence++;
+    }
+}
+
+/**
+ * @param a vertex
+ * @param b vertex
+ * @return true if @p a and @p b are connected by edges within the window
+ */
+bool SlidingWindowComponents::connected(uint64_t a, uint64_t b) {
+    if (a == b) return true;
+    auto itA = vertexNodes.find(a);
+    auto itB = vertexNodes.find(b);
+    if (itA == vertexNodes.end() || itB == vertexNodes.end()) return false;
+    return findRoot(itA->second) == findRoot(itB->second);
+}
+
+/**
+ * @param vertex
+ * @return a vertex representing the component of @p vertex, stays the same until the window changes
+ */
+uint64_t SlidingWindowComponents::componentOf(uint64_t vertex) {
+    auto it = vertexNodes.find(vertex);
+    if (it == vertexNodes.end()) return vertex;
+    return vertexIds[findRoot(it->second)];
+}
+
+/**
+ * @return number of components among the vertices that have an edge within the window
+ */
+uint64_t SlidingWindowComponents::getComponentCount() const {
+    return activeVertices - treeEdges;
+}
+
+/**
+ * @return number of undirected edges within the window
+ */
+uint64_t SlidingWindowComponents::getEdgeCount() const {
+    return edges.size();
+}
+
+size_t SlidingWindowComponents::vertexNode(uint64_t vertex) {
+    auto it = vertexNodes.find(vertex);
+    if (it != vertexNodes.end()) return it->second;
+    size_t x = nodes.size();
+    nodes.emplace_back();
+    nodes[x].minimum = x;
+    vertexNodes.emplace(vertex, x);
+    vertexIds.resize(nodes.size());
+    vertexIds[x] = vertex;
+    degrees.resize(nodes.size(), 0);
+    return x;
+}
+
+size_t SlidingWindowComponents::newEdgeNode(uint64_t time, uint64_t sequence, size_t a, size_t b) {
+    size_t x;
+    if (!freeNodes.empty()) {
+        x = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[x] = Node{};
+    } else {
+        x = nodes.size();
+        nodes.emplace_back();
+        vertexIds.resize(nodes.size());
+        degrees.resize(nodes.size(), 0);
+    }
+    nodes[x].value = time;
+    nodes[x].minimum = x;
+    nodes[x].endpoints[0] = a;
+    nodes[x].endpoints[1] = b;
+    nodes[x].sequence = sequence;
+    return x;
+}
+
+/**
+ * Cuts forest edge @p e from both of its vertices and recycles its node.
+ * @param e edge node
+ */
+void SlidingWindowComponents::removeTreeEdge(size_t e) {
+    cut(nodes[e].endpoints[0], e);
+    cut(e, nodes[e].endpoints[1]);
+    freeNodes.push_back(e);
+    treeEdges--;
+}
+
+/**
+ * @param x node
+ * @return true if @p x is the root of its splay tree
+ */
+bool SlidingWindowComponents::isRoot(size_t x) const {
+    size_t p = nodes[x].parent;
+    return p == nil || (nodes[p].children[0] != x && nodes[p].children[1] != x);
+}
+
+void SlidingWindowComponents::push(size_t x) {
+    if (!nodes[x].reversed) return;
+    std::swap(nodes[x].children[0], nodes[x].children[1]);
+    for (size_t child: nodes[x].children) {
+        if (child != nil) nodes[child].reversed = !nodes[child].reversed;
+    }
+    nodes[x].reversed = false;
+}
+
+void SlidingWindowComponents::pull(size_t x) {
+    size_t minimum = x;
+    for (size_t child: nodes[x].children) {
+        if (child != nil && nodes[nodes[child].minimum].value < nodes[minimum].value) minimum = nodes[child].minimum;
+    }
+    nodes[x].minimum = minimum;
+}
+
+void SlidingWindowComponents::rotate(size_t x) {
+    size_t p = nodes[x].parent;
+    size_t g = nodes[p].parent;
+    int side = nodes[p].children[1] == x;
+    if (!isRoot(p)) nodes[g].children[nodes[g].children[1] == p] = x;
+    nodes[x].parent = g;
+
+    size_t inner = nodes[x].children[1 - side];
+    nodes[p].children[side] = inner;
+    if (inner != nil) nodes[inner].parent = p;
+    nodes[x].children[1 - side] = p;
+    nodes[p].parent = x;
+    pull(p);
+    pull(x);
+}
+
+void SlidingWindowComponents::splay(size_t x) {
+    //pending reversals have to be applied from the top of the splay tree down to x
+    std::vector<size_t> path{x};
+    for (size_t y = x; !isRoot(y); y = nodes[y].parent) path.push_back(nodes[y].parent);
+    for (auto it = path.rbegin(); it != path.rend(); ++it) push(*it);
+
+    while (!isRoot(x)) {
+        size_t p = nodes[x].parent;
+        if (!isRoot(p)) {
+            size_t g = nodes[p].parent;
+            bool sameSide = (nodes[g].children[0] == p) == (nodes[p].children[0] == x);
+            rotate(sameSide ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+/**
+ * Makes the path from the root of the represented tree to @p x the preferred path, @p x ends up as root of its
+ * splay tree.
+ * @param x node
+ */
+void SlidingWindowComponents::access(size_t x) {
+    size_t last = nil;
+    for (size_t y = x; y != nil; y = nodes[y].parent) {
+        splay(y);
+        nodes[y].children[1] = last;
+        pull(y);
+        last = y;
+    }
+    splay(x);
+}
+
+void SlidingWindowComponents::makeRoot(size_t x) {
+    access(x);
+    nodes[x].reversed = !nodes[x].reversed;
+}
+
+size_t SlidingWindowComponents::findRoot(size_t x) {
+    access(x);
+    while (true) {
+        push(x);
+        if (nodes[x].children[0] == nil) break;
+        x = nodes[x].children[0];
+    }
+    splay(x);
+    return x;
+}
+
+/**
+ * @param x root of its tree after the call
+ * @param y node of another tree
+ */
+void SlidingWindowComponents::link(size_t x, size_t y) {
+    makeRoot(x);
+    nodes[x].parent = y;
+}
+
+/**
+ * @param x node
+ * @param y node adjacent to @p x in the represented tree
+ */
+void SlidingWindowComponents::cut(size_t x, size_t y) {
+    makeRoot(x);
+    access(y);
+    nodes[y].children[0] = nil;
+    nodes[x].parent = nil;
+    pull(y);
+}
@@ -0,0 +1,84 @@
+#ifndef TEMPUS_SLIDING_COMPONENTS_H
+#define TEMPUS_SLIDING_COMPONENTS_H
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "adj_list.h"
+
+/**
+ * Connected components of the last @p window timestamps of a stream. Keeps a spanning forest that is maximal with
+ * respect to the edge timestamps in a link cut tree: a new edge that closes a cycle replaces the oldest edge on it,
+ * so an expiring forest edge never has a replacement and can simply be cut. Every edge that enters or leaves the
+ * window costs O(log n) amortized.
+ * Timestamps have to arrive in ascending order and must not change once they were added.
+ */
+class SlidingWindowComponents{
+public:
+    explicit SlidingWindowComponents(uint64_t window);
+    void slideTo(AdjList &graph, uint64_t end);
+    void addEdge(uint64_t source, uint64_t destination, uint64_t time);
+    void expireBefore(uint64_t start);
+    bool connected(uint64_t a, uint64_t b);
+    uint64_t componentOf(uint64_t vertex);
+    uint64_t getComponentCount() const;
+    uint64_t getEdgeCount() const;
+
+private:
+    static constexpr size_t nil = std::numeric_limits<size_t>::max();
+
+    //splay tree node of the link cut tree, vertices and forest edges are both nodes
+    struct Node{
+        size_t children[2] = {nil, nil};
+        size_t parent = nil;
+        bool reversed = false;
+        //timestamp of an edge node, max for vertex nodes
+        uint64_t value = std::numeric_limits<uint64_t>::max();
+        //node with the smallest value in the splay subtree
+        size_t minimum = 0;
+        //for edge nodes: the two vertex nodes and the position of the edge in the window
+        size_t endpoints[2] = {nil, nil};
+        uint64_t sequence = 0;
+    };
+
+    struct WindowEdge{
+        uint64_t time;
+        size_t source;
+        size_t destination;
+        //edge node while the edge is part of the forest
+        size_t treeNode;
+    };
+
+    uint64_t window;
+    uint64_t end = 0;
+    std::vector<Node> nodes;
+    std::vector<size_t> freeNodes;
+    std::unordered_map<uint64_t, size_t> vertexNodes;
+    std::vector<uint64_t> vertexIds;
+    //number of window edges per vertex node
+    std::vector<uint64_t> degrees;
+    uint64_t activeVertices = 0;
+    uint64_t treeEdges = 0;
+
+    //edges of the window in the order they were added, firstSequence is the sequence number of the front
+    std::deque<WindowEdge> edges;
+    uint64_t firstSequence = 0;
+
+    size_t vertexNode(uint64_t vertex);
+    size_t newEdgeNode(uint64_t time, uint64_t sequence, size_t a, size_t b);
+    bool isRoot(size_t x) const;
+    void push(size_t x);
+    void pull(size_t x);
+    void rotate(size_t x);
+    void splay(size_t x);
+    void access(size_t x);
+    void makeRoot(size_t x);
+    size_t findRoot(size_t x);
+    void link(size_t x, size_t y);
+    void cut(size_t x, size_t y);
+    void removeTreeEdge(size_t e);
+};
+
+#endif //TEMPUS_SLIDING_COMPONENTS_H
@@ -0,0 +1,87 @@
+#include "snapshot.h"
+
+#include <algorithm>
+
+/**
+ * @param source node whose destinations are requested
+ * @return sorted destinations of @p source, empty if it has no edges in this partition
+ */
+DestinationSpan FrozenPartition::neighbours(uint64_t source) const {
+    auto it = std::lower_bound(sources.begin(), sources.end(), source);
+    if (it == sources.end() || *it != source) return {nullptr, nullptr};
+    size_t i = it - sources.begin();
+    return {destinations.data() + offsets[i], destinations.data() + offsets[i + 1]};
+}
+
+/**
+ * @param source node whose destinations are requested
+ * @return sorted destinations of @p source, empty if it has no edges in this partition
+ */
+DestinationSpan SnapshotPartition::neighbours(uint64_t source) const {
+    auto it = std::lower_bound(sources.begin(), sources.end(), source);
+    if (it == sources.end() || *it != source) return {nullptr, nullptr};
+    const std::vector<uint64_t> &row = *rows[it - sources.begin()];
+    return {row.data(), row.data() + row.size()};
+}
+
+uint64_t Snapshot::getVersion() const {
+    return version;
+}
+
+/**
+ * @return number of timestamps in this snapshot
+ */
+size_t Snapshot::getSize() const {
+    return partitions.size();
+}
+
+/**
+ * Checks if the given edge exists in this snapshot.
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param time timestamp of the edge
+ * @return true if the edge was found
+ */
+bool Snapshot::findEdge(uint64_t source, uint64_t destination, uint64_t time) const {
+    auto it = partitions.find(time);
+    if (it == partitions.end()) return false;
+    auto destinations = it->second->neighbours(source);
+    return std::binary_search(destinations.begin(), destinations.end(), destination);
+}
+
+/**
+ * Checks if an edge between @p source and @p destination exists in the given range of timestamps.
+ * @param source node of the edge
+ * @param destination node of the edge
+ * @param start of the range inclusive
+ * @param end end of the range exclusive
+ * @return true if at least one edge was found
+ * @overload
+ */
+bool Snapshot::findEdge(uint64_t source, uint64_t destination, uint64_t start, uint64_t end) const {
+    for (auto it = partitions.lower_bound(start); it != partitions.end() && it->first < end; ++it) {
+        auto destinations = it->second->neighbours(source);
+        if (std::binary_search(destinations.begin(), destinations.end(), destination)) return true;
+    }
+    return false;
+}
+
+/**
+ * @param timestamp
+ * @return number of directed edges at @p timestamp
+ */
+size_t Snapshot::getEdgeCount(uint64_t timestamp) const {
+    auto it = partitions.find(timestamp);
+    if (it == partitions.end()) return 0;
+    return it->second->edges;
+}
+
+/**
+ * @param timestamp
+ * @return partition of @p timestamp, nullptr if it is not in this snapshot
+ */
+std::shared_ptr<const SnapshotPartition> Snapshot::getPartition(uint64_t timestamp) const {
+    auto it = partitions.find(timestamp);
+    if (it == partitions.end()) return nullptr;
+    return it->second;
+}
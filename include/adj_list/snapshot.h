@@ -0,0 +1,81 @@
+#ifndef TEMPUS_SNAPSHOT_H
+#define TEMPUS_SNAPSHOT_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include "parlay/slice.h"
+
+typedef parlay::slice<const uint64_t*, const uint64_t*> DestinationSpan;
+
+/**
+ * Immutable copy of one timestamp. Sources are sorted and point into one array of sorted destinations (CSR layout).
+ */
+struct FrozenPartition{
+    uint64_t time = 0;
+    std::vector<uint64_t> sources;
+    std::vector<uint64_t> offsets;
+    std::vector<uint64_t> destinations;
+
+    DestinationSpan neighbours(uint64_t source) const;
+};
+
+/**
+ * One timestamp of a snapshot. Sources are sorted and every one owns an immutable sorted list of destinations. The
+ * lists are shared between versions, publishing a batch only copies the lists of the sources it touched.
+ */
+struct SnapshotPartition{
+    uint64_t time = 0;
+    //number of directed edges
+    uint64_t edges = 0;
+    std::vector<uint64_t> sources;
+    std::vector<std::shared_ptr<const std::vector<uint64_t>>> rows;
+
+    DestinationSpan neighbours(uint64_t source) const;
+};
+
+/**
+ * Consistent read only version of an AdjList. A snapshot is published after every applied batch and shares all
+ * partitions that the batch did not touch with the previous version, and within the touched partitions all sources
+ * that the batch did not touch. Readers keep a version alive by holding the
+ * shared pointer, it is reclaimed as soon as the last reader releases it.
+ */
+class Snapshot{
+public:
+    uint64_t getVersion() const;
+    size_t getSize() const;
+    bool findEdge(uint64_t source, uint64_t destination, uint64_t time) const;
+    bool findEdge(uint64_t source, uint64_t destination, uint64_t start, uint64_t end) const;
+    size_t getEdgeCount(uint64_t timestamp) const;
+    std::shared_ptr<const SnapshotPartition> getPartition(uint64_t timestamp) const;
+    template<typename F>
+    void visitRange(uint64_t start, uint64_t end, F &&f) const;
+
+private:
+    friend class AdjList;
+
+    uint64_t version = 0;
+    std::map<uint64_t, std::shared_ptr<const SnapshotPartition>> partitions;
+};
+
+/**
+ * Calls @p f(time, source, destinations) for every source that has edges within the given range, ordered by time and
+ * source. Runs on the calling thread: parlay only accepts parallel work from one thread outside its workers, which
+ * is the thread that applies the batches.
+ * @param start of the range inclusive
+ * @param end of the range exclusive
+ * @param f
+ */
+template<typename F>
+void Snapshot::visitRange(uint64_t start, uint64_t end, F &&f) const {
+    for (auto it = partitions.lower_bound(start); it != partitions.end() && it->first < end; ++it) {
+        const SnapshotPartition &p = *it->second;
+        for (size_t j = 0; j < p.sources.size(); j++) {
+            const uint64_t *destinations = p.rows[j]->data();
+            f(p.time, p.sources[j], DestinationSpan(destinations, destinations + p.rows[j]->size()));
+        }
+    }
+}
+
+#endif //TEMPUS_SNAPSHOT_H
@@ -0,0 +1,49 @@
+#include "temporal_paths.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * @param vertex
+ * @return position of @p vertex in vertices, or max uint64 if it has no edge in the window
+ */
+uint64_t TemporalLabels::indexOf(uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return std::numeric_limits<uint64_t>::max();
+    return it - vertices.begin();
+}
+
+/**
+ * @param vertex
+ * @return value of @p vertex, or max uint64 if it is not reached or has no edge in the window
+ */
+uint64_t TemporalLabels::valueOf(uint64_t vertex) const {
+    uint64_t index = indexOf(vertex);
+    if (index == std::numeric_limits<uint64_t>::max()) return index;
+    return values[index];
+}
+
+/**
+ * @param sourceIndex position of the source in sources
+ * @param vertex
+ * @return earliest arrival at @p vertex, or max uint64 if it is not reached or has no edge in the window
+ */
+uint64_t MultiSourceArrivals::arrivalOf(size_t sourceIndex, uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return std::numeric_limits<uint64_t>::max();
+    return arrivals[sourceIndex * vertices.size() + (it - vertices.begin())];
+}
+
+/**
+ * @param sourceIndex position of the source in sources
+ * @return sorted vertices that the source reaches, including itself if it has an edge in the window
+ */
+parlay::sequence<uint64_t> MultiSourceArrivals::reachable(size_t sourceIndex) const {
+    size_t n = vertices.size();
+    auto row = arrivals.cut(sourceIndex * n, (sourceIndex + 1) * n);
+    auto indices = parlay::pack_index(parlay::tabulate(n, [&](size_t i) {
+        return row[i] != std::numeric_limits<uint64_t>::max();
+    }));
+    return parlay::map(indices, [&](size_t i) { return vertices[i]; });
+}
@@ -0,0 +1,33 @@
+#ifndef TEMPUS_TEMPORAL_PATHS_H
+#define TEMPUS_TEMPORAL_PATHS_H
+
+#include <cstdint>
+#include <vector>
+#include "parlay/sequence.h"
+
+/**
+ * Result of a single source temporal path query. @p values[i] belongs to @p vertices[i], the sorted vertices that
+ * have an edge within the window. Vertices the query does not reach have the value max uint64.
+ */
+struct TemporalLabels{
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<uint64_t> values;
+
+    uint64_t valueOf(uint64_t vertex) const;
+    uint64_t indexOf(uint64_t vertex) const;
+};
+
+/**
+ * Earliest arrival times of several sources. The arrival of source number i at @p vertices[j] is
+ * @p arrivals[i * vertices.size() + j], max uint64 if it is not reached.
+ */
+struct MultiSourceArrivals{
+    std::vector<uint64_t> sources;
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<uint64_t> arrivals;
+
+    uint64_t arrivalOf(size_t sourceIndex, uint64_t vertex) const;
+    parlay::sequence<uint64_t> reachable(size_t sourceIndex) const;
+};
+
+#endif //TEMPUS_TEMPORAL_PATHS_H
@@ -0,0 +1,32 @@
+#include "adj_list.h"
+#include "parlay/parallel.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+//inserts batches that all fall into one timestamp, run with PARLAY_NUM_THREADS=1,2,4,... to see how the split of hot
+//timestamps scales
+int main(int argc, char **argv) {
+    uint64_t batchSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    uint64_t batches = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    std::mt19937_64 random(1);
+    AdjList graph;
+    double seconds = 0;
+    for (uint64_t batch = 0; batch < batches; batch++) {
+        std::vector<uint64_t> sources(batchSize), destinations(batchSize), times(batchSize, 1);
+        for (uint64_t i = 0; i < batchSize; i++) {
+            sources[i] = random() % (batchSize / 4);
+            destinations[i] = random() % (batchSize / 4);
+        }
+        auto start = std::chrono::steady_clock::now();
+        graph.applyBatch(true, sources, destinations, times);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::cout << "workers " << parlay::num_workers() << ", " << batches << " batches of " << batchSize
+              << " edges into one timestamp: " << seconds << " s, "
+              << batches * batchSize / seconds / 1e6 << " M edges/s" << std::endl;
+    return 0;
+}
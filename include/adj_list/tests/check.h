@@ -0,0 +1,16 @@
+#ifndef TEMPUS_TESTS_CHECK_H
+#define TEMPUS_TESTS_CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+//like assert, but also checked in release builds
+#define CHECK(condition)                                                                 \
+    do {                                                                                 \
+        if (!(condition)) {                                                              \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                                \
+        }                                                                                \
+    } while (0)
+
+#endif //TEMPUS_TESTS_CHECK_H
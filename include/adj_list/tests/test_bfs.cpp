@@ -0,0 +1,93 @@
+#include "window_graph.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<uint64_t> serialBfs(const WindowGraph &graph, uint64_t source) {
+    std::vector<uint64_t> distances(graph.numVertices(), UINT64_MAX);
+    std::queue<uint64_t> queue;
+    distances[source] = 0;
+    queue.push(source);
+    while (!queue.empty()) {
+        uint64_t u = queue.front();
+        queue.pop();
+        for (uint64_t v: graph.neighbours(u)) {
+            if (distances[v] != UINT64_MAX) continue;
+            distances[v] = distances[u] + 1;
+            queue.push(v);
+        }
+    }
+    return distances;
+}
+
+//distances have to match, every parent has to be a neighbour one level closer to the source
+void checkBfs(const WindowGraph &graph, uint64_t sourceIndex) {
+    auto expected = serialBfs(graph, sourceIndex);
+    auto result = graph.bfs(graph.vertexId(sourceIndex));
+    for (uint64_t v = 0; v < graph.numVertices(); v++) {
+        CHECK(result.distances[v] == expected[v]);
+        if (v == sourceIndex) {
+            CHECK(result.parents[v] == v);
+        } else if (expected[v] == UINT64_MAX) {
+            CHECK(result.parents[v] == UINT64_MAX);
+        } else {
+            uint64_t parent = result.parents[v];
+            CHECK(expected[parent] + 1 == expected[v]);
+            auto neighbours = graph.neighbours(v);
+            CHECK(std::find(neighbours.begin(), neighbours.end(), parent) != neighbours.end());
+        }
+    }
+}
+
+}
+
+int main() {
+    //a dense random core of 2000 vertices with a path of 300 vertices on either side and a separate component. A
+    //search from the end of a path expands small frontiers top down, switches to bottom up once it reaches the core
+    //and back to top down on the other path
+    std::mt19937_64 random(45);
+    const uint64_t core = 2000, path = 300;
+    std::set<std::pair<uint64_t, uint64_t>> edges;
+    auto addEdge = [&](uint64_t a, uint64_t b) {
+        if (a != b) edges.emplace(std::min(a, b), std::max(a, b));
+    };
+    for (int i = 0; i < 12000; i++) addEdge(random() % core, random() % core);
+    for (uint64_t i = 0; i < path; i++) {
+        addEdge(i == 0 ? 0 : core + i - 1, core + i);
+        addEdge(i == 0 ? 1 : core + path + i - 1, core + path + i);
+    }
+    const uint64_t separate = core + 2 * path;
+    for (uint64_t i = 0; i < 50; i++) addEdge(separate + i, separate + (i + 1) % 50);
+
+    //ids are not indices, and one vertex is isolated
+    parlay::sequence<uint64_t> vertices;
+    for (uint64_t i = 0; i <= separate + 50; i++) vertices.push_back(3 * i + 7);
+    parlay::sequence<std::pair<uint64_t, uint64_t>> pairs;
+    for (const auto &[a, b]: edges) pairs.emplace_back(3 * a + 7, 3 * b + 7);
+    WindowGraph graph(vertices, pairs);
+
+    checkBfs(graph, core + path - 1);
+    checkBfs(graph, 5);
+    checkBfs(graph, separate + 3);
+    checkBfs(graph, separate + 50);
+
+    //a search limited to k levels only labels the vertices up to distance k
+    auto expected = serialBfs(graph, core + path - 1);
+    auto limited = graph.bfs(graph.vertexId(core + path - 1), 250);
+    CHECK(limited.levels == 250);
+    for (uint64_t v = 0; v < graph.numVertices(); v++) {
+        CHECK(limited.distances[v] == (expected[v] <= 250 ? expected[v] : UINT64_MAX));
+    }
+    //an unknown source reaches nothing
+    auto unknown = graph.bfs(1);
+    for (uint64_t distance: unknown.distances) CHECK(distance == UINT64_MAX);
+    return 0;
+}
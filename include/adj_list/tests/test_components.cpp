@@ -0,0 +1,84 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+//components of all vertices that ever had an edge, computed from scratch
+uint64_t countComponents(const std::set<uint64_t> &vertices, const std::set<std::pair<uint64_t, uint64_t>> &edges) {
+    std::map<uint64_t, uint64_t> parents;
+    for (uint64_t vertex: vertices) parents[vertex] = vertex;
+    auto find = [&](uint64_t x) {
+        while (parents[x] != x) x = parents[x] = parents[parents[x]];
+        return x;
+    };
+    uint64_t components = vertices.size();
+    for (const auto &[a, b]: edges) {
+        uint64_t rootA = find(a), rootB = find(b);
+        if (rootA == rootB) continue;
+        parents[rootA] = rootB;
+        components--;
+    }
+    return components;
+}
+
+}
+
+int main() {
+    AdjList graph;
+    graph.setIncrementalComponents(true);
+
+    //{1, 2, 3} and {10, ..., 14}
+    graph.applyBatch(true, {1, 2, 10, 11, 12, 13}, {2, 3, 11, 12, 13, 14}, {1, 1, 1, 1, 1, 1});
+    CHECK(graph.getComponentCount() == 2);
+    CHECK(graph.getComponentSize(3) == 3);
+
+    //the deletion marks {1, 2, 3} dirty, before it is refreshed it is merged into the larger component
+    graph.applyBatch(false, {2}, {3}, {1});
+    graph.applyBatch(true, {3}, {10}, {1});
+    CHECK(graph.getComponentCount() == 2);
+    CHECK(graph.getComponentSize(1) == 2);
+    CHECK(graph.getComponentSize(3) == 6);
+    CHECK(graph.getComponentId(3) == graph.getComponentId(14));
+    CHECK(graph.getComponentId(1) != graph.getComponentId(3));
+
+    //random batches with queries only every few batches, so dirty components are merged before they are refreshed
+    std::mt19937_64 random(42);
+    std::set<uint64_t> vertices{1, 2, 3, 10, 11, 12, 13, 14};
+    std::set<std::pair<uint64_t, uint64_t>> edges{{1, 2}, {3, 10}, {10, 11}, {11, 12}, {12, 13}, {13, 14}};
+    for (int round = 0; round < 60; round++) {
+        std::vector<uint64_t> sources, destinations, times;
+        bool insert = round % 3 != 2;
+        if (insert) {
+            for (int i = 0; i < 20; i++) {
+                uint64_t a = random() % 200, b = random() % 200;
+                if (a == b) continue;
+                sources.push_back(a);
+                destinations.push_back(b);
+                times.push_back(1);
+                vertices.insert(a);
+                vertices.insert(b);
+                edges.emplace(std::min(a, b), std::max(a, b));
+            }
+        } else {
+            for (int i = 0; i < 15 && !edges.empty(); i++) {
+                auto it = std::next(edges.begin(), random() % edges.size());
+                sources.push_back(it->first);
+                destinations.push_back(it->second);
+                times.push_back(1);
+                edges.erase(it);
+            }
+        }
+        graph.applyBatch(insert, sources, destinations, times);
+        if (round % 4 == 3) CHECK(graph.getComponentCount() == countComponents(vertices, edges));
+    }
+    CHECK(graph.getComponentCount() == countComponents(vertices, edges));
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+//core numbers by serial peeling of one vertex of lowest degree at a time
+std::map<uint64_t, uint64_t> peel(const WindowGraph &graph) {
+    size_t n = graph.numVertices();
+    std::vector<uint64_t> degrees(n);
+    std::set<std::pair<uint64_t, size_t>> queue;
+    for (size_t v = 0; v < n; v++) {
+        degrees[v] = graph.degree(v);
+        queue.emplace(degrees[v], v);
+    }
+    std::vector<bool> peeled(n, false);
+    std::map<uint64_t, uint64_t> cores;
+    uint64_t k = 0;
+    while (!queue.empty()) {
+        auto [degree, v] = *queue.begin();
+        queue.erase(queue.begin());
+        k = std::max(k, degree);
+        cores[graph.vertexId(v)] = k;
+        peeled[v] = true;
+        for (uint64_t u: graph.neighbours(v)) {
+            if (peeled[u]) continue;
+            queue.erase({degrees[u], u});
+            queue.emplace(--degrees[u], u);
+        }
+    }
+    return cores;
+}
+
+//the parallel decomposition and the maintained core numbers have to match the serial peeling
+uint64_t checkAgainstPeeling(AdjList &graph) {
+    auto expected = peel(graph.getWindowGraph(0, UINT64_MAX));
+    auto decomposition = graph.coreDecomposition(0, UINT64_MAX);
+    CHECK(decomposition.vertices.size() == expected.size());
+    uint64_t degeneracy = 0;
+    for (size_t i = 0; i < decomposition.vertices.size(); i++) {
+        uint64_t vertex = decomposition.vertices[i];
+        CHECK(decomposition.cores[i] == expected[vertex]);
+        CHECK(graph.getCoreNumber(vertex) == expected[vertex]);
+        degeneracy = std::max(degeneracy, expected[vertex]);
+    }
+    CHECK(decomposition.degeneracy == degeneracy);
+    CHECK(graph.getDegeneracy() == degeneracy);
+    return degeneracy;
+}
+
+}
+
+int main() {
+    AdjList graph;
+    std::mt19937_64 random(5);
+    const uint64_t vertices = 200;
+    std::vector<uint64_t> sources, destinations, times;
+    for (int i = 0; i < 3000; i++) {
+        sources.push_back(random() % vertices);
+        destinations.push_back(random() % vertices);
+        times.push_back(random() % 5);
+    }
+    graph.applyBatch(true, sources, destinations, times);
+    //enabling computes the core numbers of the existing edges once
+    graph.setIncrementalCores(true);
+    checkAgainstPeeling(graph);
+
+    for (int round = 0; round < 15; round++) {
+        sources.clear();
+        destinations.clear();
+        times.clear();
+        for (int i = 0; i < 300; i++) {
+            sources.push_back(random() % vertices);
+            destinations.push_back(random() % vertices);
+            times.push_back(random() % 8);
+        }
+        graph.applyBatch(true, sources, destinations, times);
+        checkAgainstPeeling(graph);
+
+        //deletes every third edge plus some edges that do not exist
+        sources.clear();
+        destinations.clear();
+        times.clear();
+        uint64_t visited = 0;
+        graph.rangeQuery(0, UINT64_MAX, [&](uint64_t time, uint64_t source, uint64_t destination) {
+            if (visited++ % 3 != 0) return;
+            sources.push_back(source);
+            destinations.push_back(destination);
+            times.push_back(time);
+        });
+        for (int i = 0; i < 20; i++) {
+            sources.push_back(random() % vertices);
+            destinations.push_back(random() % vertices);
+            times.push_back(random() % 8);
+        }
+        graph.applyBatch(false, sources, destinations, times);
+        checkAgainstPeeling(graph);
+
+        if (round == 7) {
+            graph.evictBefore(3);
+            checkAgainstPeeling(graph);
+        }
+    }
+
+    //a clique of 40 vertices is a 39-core, losing one edge drops it to a 38-core
+    sources.clear();
+    destinations.clear();
+    times.clear();
+    for (uint64_t i = 0; i < 40; i++) {
+        for (uint64_t j = i + 1; j < 40; j++) {
+            sources.push_back(1000 + i);
+            destinations.push_back(1000 + j);
+            times.push_back(20);
+        }
+    }
+    graph.applyBatch(true, sources, destinations, times);
+    CHECK(checkAgainstPeeling(graph) == 39);
+    graph.applyBatch(false, {1000}, {1001}, {20});
+    CHECK(checkAgainstPeeling(graph) == 38);
+    return 0;
+}
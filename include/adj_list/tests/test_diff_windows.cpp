@@ -0,0 +1,95 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+typedef std::pair<uint64_t, uint64_t> Pair;
+
+//timestamps of every undirected edge, with the smaller vertex first
+std::map<Pair, std::set<uint64_t>> reference;
+
+std::vector<Pair> pairsOf(uint64_t start, uint64_t end) {
+    std::vector<Pair> pairs;
+    for (const auto &[pair, times]: reference) {
+        auto it = times.lower_bound(start);
+        if (it != times.end() && *it < end) pairs.push_back(pair);
+    }
+    return pairs;
+}
+
+//both callbacks receive the set differences in ascending order
+void checkDiff(AdjList &graph, uint64_t oldStart, uint64_t oldEnd, uint64_t newStart, uint64_t newEnd) {
+    std::vector<Pair> added, removed;
+    graph.diffWindows(oldStart, oldEnd, newStart, newEnd,
+                      [&](uint64_t a, uint64_t b) { added.emplace_back(a, b); },
+                      [&](uint64_t a, uint64_t b) { removed.emplace_back(a, b); });
+    auto oldPairs = pairsOf(oldStart, oldEnd), newPairs = pairsOf(newStart, newEnd);
+    std::vector<Pair> expectedAdded, expectedRemoved;
+    std::set_difference(newPairs.begin(), newPairs.end(), oldPairs.begin(), oldPairs.end(),
+                        std::back_inserter(expectedAdded));
+    std::set_difference(oldPairs.begin(), oldPairs.end(), newPairs.begin(), newPairs.end(),
+                        std::back_inserter(expectedRemoved));
+    CHECK(added == expectedAdded);
+    CHECK(removed == expectedRemoved);
+}
+
+}
+
+int main() {
+    AdjList graph;
+    std::mt19937_64 random(40);
+    std::vector<uint64_t> sources, destinations, times;
+    //few vertices, so most edges exist at several timestamps
+    for (int i = 0; i < 800; i++) {
+        uint64_t a = random() % 40, b = random() % 40, time = random() % 10;
+        if (a == b) continue;
+        sources.push_back(a);
+        destinations.push_back(b);
+        times.push_back(time);
+        reference[{std::min(a, b), std::max(a, b)}].insert(time);
+    }
+    //an edge at 1 and 7 is in both halves and never reported between them
+    sources.push_back(101);
+    destinations.push_back(100);
+    times.push_back(1);
+    sources.push_back(100);
+    destinations.push_back(101);
+    times.push_back(7);
+    reference[{100, 101}] = {1, 7};
+    graph.applyBatch(true, sources, destinations, times);
+
+    //overlapping, nested, adjacent and identical windows
+    checkDiff(graph, 0, 5, 3, 8);
+    checkDiff(graph, 3, 8, 0, 5);
+    checkDiff(graph, 2, 6, 0, 10);
+    checkDiff(graph, 0, 5, 5, 10);
+    checkDiff(graph, 4, 9, 4, 9);
+    std::vector<Pair> reported;
+    graph.diffWindows(0, 5, 5, 10, [&](uint64_t a, uint64_t b) { reported.emplace_back(a, b); },
+                      [&](uint64_t a, uint64_t b) { reported.emplace_back(a, b); });
+    CHECK(std::find(reported.begin(), reported.end(), Pair(100, 101)) == reported.end());
+
+    //empty windows, because they lie behind the data or have no width, report the other window completely
+    checkDiff(graph, 20, 30, 0, 10);
+    checkDiff(graph, 0, 10, 20, 30);
+    checkDiff(graph, 3, 3, 2, 4);
+    checkDiff(graph, 2, 4, 3, 3);
+    checkDiff(graph, 3, 3, 20, 30);
+
+    //a deleted edge is reported by the window that still contains it
+    uint64_t a = sources[0], b = destinations[0], time = times[0];
+    graph.applyBatch(false, {a}, {b}, {time});
+    reference[{std::min(a, b), std::max(a, b)}].erase(time);
+    checkDiff(graph, 0, time + 1, time, 10);
+    checkDiff(graph, time, time + 1, 0, 10);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "edge_cursor.h"
+#include "check.h"
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+typedef std::tuple<uint64_t, uint64_t, uint64_t> Key;
+
+Key keyOf(const EdgeKey &edge) {
+    return {edge.time, edge.source, edge.destination};
+}
+
+std::vector<EdgeKey> walk(EdgeCursor &cursor) {
+    std::vector<EdgeKey> edges;
+    while (cursor.fetch(64, edges) == 64) {}
+    CHECK(cursor.finished());
+    return edges;
+}
+
+bool sameEdge(const EdgeKey &a, const EdgeKey &b) {
+    return keyOf(a) == keyOf(b);
+}
+
+}
+
+int main() {
+    AdjList graph;
+    std::mt19937_64 random(36);
+    //directed edges in [1, 5), both directions of every inserted edge
+    std::set<Key> reference;
+    std::vector<uint64_t> sources, destinations, times;
+    for (int i = 0; i < 600; i++) {
+        uint64_t a = random() % 100, b = random() % 100, time = random() % 6;
+        if (a == b) continue;
+        sources.push_back(a);
+        destinations.push_back(b);
+        times.push_back(time);
+        if (time >= 1 && time < 5) {
+            reference.emplace(time, a, b);
+            reference.emplace(time, b, a);
+        }
+    }
+    graph.applyBatch(true, sources, destinations, times);
+
+    //a sorted cursor returns every edge of the range once, ordered by time and source
+    EdgeCursor full(graph, 1, 5);
+    auto all = walk(full);
+    std::set<Key> walked;
+    for (const auto &edge: all) walked.insert(keyOf(edge));
+    CHECK(all.size() == reference.size() && walked == reference);
+    for (size_t i = 1; i < all.size(); i++) {
+        CHECK(std::make_pair(all[i - 1].time, all[i - 1].source) <= std::make_pair(all[i].time, all[i].source));
+    }
+
+    //pages of a new cursor per token concatenate to the same walk
+    std::vector<EdgeKey> paged;
+    CursorToken token;
+    {
+        EdgeCursor first(graph, 1, 5);
+        first.fetch(37, paged);
+        token = first.token();
+    }
+    while (!token.finished) {
+        EdgeCursor resumed(graph, token, 5);
+        resumed.fetch(37, paged);
+        token = resumed.token();
+    }
+    CHECK(paged.size() == all.size());
+    for (size_t i = 0; i < all.size(); i++) CHECK(sameEdge(paged[i], all[i]));
+    EdgeCursor afterEnd(graph, token, 5);
+    EdgeKey edge{};
+    CHECK(!afterEnd.next(edge));
+
+    //stops in the middle of a source of timestamp 2 with at least 40 sources before it
+    EdgeCursor cursor(graph, 1, 5);
+    size_t consumed = 0;
+    while (true) {
+        token = cursor.token();
+        if (token.time == 2 && token.source >= 40 && token.offset > 0) break;
+        CHECK(cursor.next(edge));
+        consumed++;
+    }
+
+    //an edge between two earlier sources of the current timestamp lies behind the token, an edge between new
+    //vertices at the same timestamp and one at a later timestamp lie ahead of it
+    uint64_t a = 0, b = 1;
+    while (reference.count({2, a, b})) b++;
+    CHECK(b < token.source);
+    graph.applyBatch(true, {a, 1000, 2000}, {b, 1001, 2001}, {2, 2, 3});
+
+    EdgeCursor resumed(graph, token, 5);
+    auto rest = walk(resumed);
+    CHECK(sameEdge(rest[0], all[consumed]));
+    std::set<Key> expected;
+    for (size_t i = consumed; i < all.size(); i++) expected.insert(keyOf(all[i]));
+    for (const Key &key: std::vector<Key>{{2, 1000, 1001}, {2, 1001, 1000}, {3, 2000, 2001}, {3, 2001, 2000}}) {
+        expected.insert(key);
+    }
+    std::set<Key> seen;
+    for (const auto &e: rest) CHECK(seen.insert(keyOf(e)).second);
+    CHECK(seen == expected);
+
+    //an unsorted cursor visits the same edges and resumes where it stopped while the graph is unchanged
+    EdgeCursor unsorted(graph, 1, 5, false);
+    std::vector<EdgeKey> head;
+    unsorted.fetch(101, head);
+    EdgeCursor unsortedResumed(graph, unsorted.token(), 5, false);
+    auto tail = walk(unsortedResumed);
+    auto unsortedRest = walk(unsorted);
+    CHECK(tail.size() == unsortedRest.size());
+    for (size_t i = 0; i < tail.size(); i++) CHECK(sameEdge(tail[i], unsortedRest[i]));
+    CHECK(head.size() + tail.size() == all.size() + 6);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+//a batch that falls into one timestamp is split into several tasks, which must produce the same graph, counters and
+//vertex bitmap as applying the edges one by one
+int main() {
+    const uint64_t time = 7;
+    std::vector<uint64_t> sources, destinations, times;
+    std::set<std::pair<uint64_t, uint64_t>> expected;
+    for (uint64_t i = 0; i < 40000; i++) {
+        uint64_t source = (i * 7919) % 3000;
+        uint64_t destination = (i * 104729) % 5000;
+        sources.push_back(source);
+        destinations.push_back(destination);
+        times.push_back(time);
+        if (source != destination) {
+            expected.emplace(source, destination);
+            expected.emplace(destination, source);
+        }
+    }
+    //both directions of some edges within the same batch
+    for (uint64_t i = 0; i < 2000; i++) {
+        sources.push_back(destinations[i]);
+        destinations.push_back(sources[i]);
+        times.push_back(time);
+    }
+
+    AdjList graph;
+    graph.applyBatch(true, sources, destinations, times);
+    std::set<uint64_t> vertices;
+    uint64_t selfLoops = 0;
+    for (uint64_t i = 0; i < sources.size(); i++) {
+        CHECK(graph.findEdge(sources[i], destinations[i], time));
+        CHECK(graph.findEdge(destinations[i], sources[i], time));
+        vertices.insert(sources[i]);
+        vertices.insert(destinations[i]);
+    }
+    for (uint64_t vertex: vertices) {
+        if (graph.findEdge(vertex, vertex, time)) selfLoops++;
+    }
+    TimestampStats stats = graph.getStats(time);
+    CHECK(stats.edges == expected.size() + selfLoops);
+    CHECK(stats.edges == graph.getEdgeCount(time));
+    CHECK(stats.sources == vertices.size());
+    auto bitmap = graph.getVertexBitmap(0, 100).toSequence();
+    CHECK(std::equal(bitmap.begin(), bitmap.end(), vertices.begin(), vertices.end()));
+
+    //deleting half of the edges, including duplicates in both directions
+    std::vector<uint64_t> deleteSources(sources.begin(), sources.begin() + 20000);
+    std::vector<uint64_t> deleteDestinations(destinations.begin(), destinations.begin() + 20000);
+    std::vector<uint64_t> deleteTimes(20000, time);
+    for (uint64_t i = 0; i < 1000; i++) {
+        deleteSources.push_back(destinations[i]);
+        deleteDestinations.push_back(sources[i]);
+        deleteTimes.push_back(time);
+    }
+    graph.applyBatch(false, deleteSources, deleteDestinations, deleteTimes);
+    uint64_t remaining = 0;
+    graph.rangeQuery(0, 100, [&](uint64_t, uint64_t source, uint64_t destination) {
+        CHECK(graph.findEdge(destination, source, time));
+        remaining++;
+    });
+    for (uint64_t i = 0; i < 20000; i++) CHECK(!graph.findEdge(sources[i], destinations[i], time));
+    stats = graph.getStats(time);
+    CHECK(stats.edges == remaining);
+    CHECK(stats.edges == graph.getEdgeCount(time));
+    CHECK(stats.sources == graph.getVertexBitmap(0, 100).toSequence().size());
+
+    //deleting everything removes the timestamp once all tasks are done
+    graph.applyBatch(false, sources, destinations, times);
+    CHECK(graph.getSize() == 0);
+    CHECK(graph.getStats(time).edges == 0);
+    CHECK(graph.getVertexBitmap(0, 100).toSequence().empty());
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "ingestion_service.h"
+#include "check.h"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+int main() {
+    AdjList graph;
+    const uint64_t producers = 4;
+    const uint64_t batchesPerProducer = 200;
+    {
+        //a tiny queue, so producers run into a full queue
+        IngestionService service(graph, 2, 64);
+        std::vector<std::thread> threads;
+        for (uint64_t p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                for (uint64_t b = 0; b < batchesPerProducer; b++) {
+                    EdgeBatch batch;
+                    batch.sources = {p * 10000 + b};
+                    batch.destinations = {p * 10000 + b + 1};
+                    batch.times = {b % 4};
+                    service.enqueue(std::move(batch));
+                }
+            });
+        }
+        for (auto &thread: threads) thread.join();
+        service.flush();
+
+        IngestionMetrics metrics = service.getMetrics();
+        CHECK(metrics.enqueuedBatches == producers * batchesPerProducer);
+        CHECK(metrics.appliedBatches == producers * batchesPerProducer);
+        CHECK(metrics.appliedEdges == producers * batchesPerProducer);
+        //every batch is rejected at most once, however often enqueue retried it
+        CHECK(metrics.rejectedEnqueues <= producers * batchesPerProducer);
+        CHECK(metrics.queueDepth == 0);
+        for (uint64_t p = 0; p < producers; p++) {
+            for (uint64_t b = 0; b < batchesPerProducer; b++) {
+                CHECK(graph.findEdge(p * 10000 + b, p * 10000 + b + 1, b % 4));
+            }
+        }
+
+        //an idle writer sleeps instead of polling
+        std::clock_t cpuBefore = std::clock();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        double cpuSeconds = double(std::clock() - cpuBefore) / CLOCKS_PER_SEC;
+        CHECK(cpuSeconds < 0.05);
+
+        //and wakes up for the next batch
+        EdgeBatch batch;
+        batch.sources = {1};
+        batch.destinations = {2};
+        batch.times = {9};
+        CHECK(service.tryEnqueue(std::move(batch)));
+        service.flush();
+        CHECK(graph.findEdge(1, 2, 9));
+
+        //after stop batches are rejected and flush does not wait for them
+        service.stop();
+        uint64_t rejectedBefore = service.getMetrics().rejectedEnqueues;
+        EdgeBatch late;
+        late.sources = {3};
+        late.destinations = {4};
+        late.times = {9};
+        CHECK(!service.enqueue(std::move(late)));
+        CHECK(!service.tryEnqueue(std::move(late)));
+        service.flush();
+        CHECK(service.getMetrics().rejectedEnqueues == rejectedBefore + 2);
+        CHECK(!graph.findEdge(3, 4, 9));
+    }
+    {
+        //producers racing with stop, every batch that was accepted is applied
+        IngestionService service(graph, 4, 64);
+        std::atomic<uint64_t> accepted(0);
+        std::vector<std::thread> threads;
+        for (uint64_t p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                for (uint64_t b = 0;; b++) {
+                    EdgeBatch batch;
+                    batch.sources = {100000 + p};
+                    batch.destinations = {200000 + b};
+                    batch.times = {20};
+                    if (!service.enqueue(std::move(batch))) break;
+                    accepted++;
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        service.stop();
+        for (auto &thread: threads) thread.join();
+        service.flush();
+        IngestionMetrics metrics = service.getMetrics();
+        CHECK(metrics.enqueuedBatches == accepted);
+        CHECK(metrics.appliedBatches == accepted);
+        CHECK(metrics.queueDepth == 0);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+//(smaller vertex, larger vertex, time)
+typedef std::tuple<uint64_t, uint64_t, uint64_t> Event;
+
+//classifies every pair and triple of events within δ by the vertices they touch
+TemporalMotifCounts enumerate(const std::vector<Event> &events, uint64_t delta) {
+    TemporalMotifCounts counts;
+    auto withinDelta = [&](std::initializer_list<const Event*> motif) {
+        uint64_t first = UINT64_MAX, last = 0;
+        for (const Event *event: motif) {
+            first = std::min(first, std::get<2>(*event));
+            last = std::max(last, std::get<2>(*event));
+        }
+        return last - first <= delta;
+    };
+    for (size_t i = 0; i < events.size(); i++) {
+        for (size_t j = i + 1; j < events.size(); j++) {
+            const Event &a = events[i], &b = events[j];
+            if (!withinDelta({&a, &b})) continue;
+            std::set<uint64_t> vertices{std::get<0>(a), std::get<1>(a), std::get<0>(b), std::get<1>(b)};
+            if (vertices.size() == 2) counts.repeatedEdges++;
+            else if (vertices.size() == 3) counts.twoEdgeStars++;
+
+            for (size_t k = j + 1; k < events.size(); k++) {
+                const Event &c = events[k];
+                if (!withinDelta({&a, &b, &c})) continue;
+                std::set<std::pair<uint64_t, uint64_t>> pairs{{std::get<0>(a), std::get<1>(a)},
+                                                              {std::get<0>(b), std::get<1>(b)},
+                                                              {std::get<0>(c), std::get<1>(c)}};
+                if (pairs.size() < 3) continue;
+                std::map<uint64_t, uint64_t> degrees;
+                for (const auto &pair: pairs) {
+                    degrees[pair.first]++;
+                    degrees[pair.second]++;
+                }
+                std::vector<uint64_t> sorted;
+                for (const auto &degree: degrees) sorted.push_back(degree.second);
+                std::sort(sorted.begin(), sorted.end());
+                if (sorted == std::vector<uint64_t>{2, 2, 2}) counts.triangles++;
+                else if (sorted == std::vector<uint64_t>{1, 1, 1, 3}) counts.threeEdgeStars++;
+                else if (sorted == std::vector<uint64_t>{1, 1, 2, 2}) counts.threeEdgePaths++;
+            }
+        }
+    }
+    return counts;
+}
+
+}
+
+int main() {
+    std::mt19937_64 random(8);
+    for (int graphs = 0; graphs < 12; graphs++) {
+        //few vertices and timestamps, so motifs of every kind and events on the same pair are common
+        const uint64_t vertices = 8 + random() % 8;
+        const uint64_t timestamps = 3 + random() % 5;
+        std::vector<uint64_t> sources, destinations, times;
+        for (int i = 0; i < 120; i++) {
+            sources.push_back(random() % vertices);
+            destinations.push_back(random() % vertices);
+            times.push_back(random() % timestamps);
+        }
+        AdjList graph;
+        graph.applyBatch(true, sources, destinations, times);
+
+        std::set<Event> unique;
+        graph.rangeQuery(0, UINT64_MAX, [&](uint64_t time, uint64_t source, uint64_t destination) {
+            if (source < destination) unique.emplace(source, destination, time);
+        });
+        std::vector<Event> events(unique.begin(), unique.end());
+
+        for (uint64_t delta: {uint64_t(0), uint64_t(1), uint64_t(2), uint64_t(5), UINT64_MAX}) {
+            auto expected = enumerate(events, delta);
+            auto counts = graph.countTemporalMotifs(0, UINT64_MAX, delta);
+            CHECK(counts.repeatedEdges == expected.repeatedEdges);
+            CHECK(counts.twoEdgeStars == expected.twoEdgeStars);
+            CHECK(counts.threeEdgeStars == expected.threeEdgeStars);
+            CHECK(counts.threeEdgePaths == expected.threeEdgePaths);
+            CHECK(counts.triangles == expected.triangles);
+        }
+    }
+    return 0;
+}
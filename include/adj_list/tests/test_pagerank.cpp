@@ -0,0 +1,98 @@
+#include "adj_list.h"
+#include "pagerank.h"
+#include "check.h"
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+//a random graph on ids 0..n-1, every fourth vertex has no edges
+WindowGraph randomGraph(uint64_t n, uint64_t edges, uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::set<std::pair<uint64_t, uint64_t>> unique;
+    while (unique.size() < edges) {
+        uint64_t a = random() % n, b = random() % n;
+        if (a == b || a % 4 == 0 || b % 4 == 0) continue;
+        unique.emplace(std::min(a, b), std::max(a, b));
+    }
+    parlay::sequence<uint64_t> vertices;
+    for (uint64_t i = 0; i < n; i++) vertices.push_back(i);
+    parlay::sequence<std::pair<uint64_t, uint64_t>> pairs(unique.begin(), unique.end());
+    return WindowGraph(vertices, pairs);
+}
+
+double sumOf(const PageRankResult &result) {
+    double sum = 0;
+    for (double rank: result.ranks) sum += rank;
+    return sum;
+}
+
+double distance(const PageRankResult &a, const PageRankResult &b) {
+    CHECK(a.vertices == b.vertices);
+    double l1 = 0;
+    for (size_t i = 0; i < a.ranks.size(); i++) l1 += std::fabs(a.ranks[i] - b.ranks[i]);
+    return l1;
+}
+
+}
+
+int main() {
+    PageRankOptions options;
+    options.tolerance = 1e-12;
+    options.maxIterations = 1000;
+
+    //the rank of vertices without edges is redistributed, so the ranks keep summing up to 1
+    WindowGraph graph = randomGraph(400, 1500, 46);
+    auto cold = computePageRank(graph, options);
+    CHECK(cold.delta < options.tolerance);
+    CHECK(std::fabs(sumOf(cold) - 1) < 1e-9);
+    for (double rank: cold.ranks) CHECK(rank > 0);
+    //a vertex without edges only keeps its restart probability and what the others hand to it
+    CHECK(std::fabs(cold.rankOf(0) - cold.rankOf(4)) < 1e-12);
+
+    PageRankOptions personalized = options;
+    personalized.personalization = {1, 2, 4, 4, 1000};
+    auto seeded = computePageRank(graph, personalized);
+    CHECK(std::fabs(sumOf(seeded) - 1) < 1e-9);
+    CHECK(seeded.rankOf(8) == 0);
+    CHECK(seeded.rankOf(4) > 0);
+
+    //starting from the ranks of another graph, with vertices that are missing in it, ends at the same vector as a
+    //cold start
+    for (uint64_t seed = 0; seed < 4; seed++) {
+        auto previous = computePageRank(randomGraph(300 + 50 * seed, 1000, seed), options);
+        auto warm = computePageRank(graph, options, &previous);
+        CHECK(std::fabs(sumOf(warm) - 1) < 1e-9);
+        CHECK(distance(warm, cold) < 1e-9);
+    }
+    //starting at the fixed point needs a single iteration
+    auto converged = computePageRank(graph, options, &cold);
+    CHECK(converged.iterations == 1);
+    CHECK(distance(converged, cold) < 1e-11);
+
+    //a sliding window starts from the previous window and agrees with ranking every window from scratch
+    AdjList adjList;
+    std::mt19937_64 random(7);
+    std::vector<uint64_t> sources, destinations, times;
+    for (int i = 0; i < 3000; i++) {
+        uint64_t a = random() % 300, b = random() % 300;
+        if (a == b) continue;
+        sources.push_back(a);
+        destinations.push_back(b);
+        times.push_back(random() % 10);
+    }
+    adjList.applyBatch(true, sources, destinations, times);
+    WindowedPageRank windowed(options);
+    for (uint64_t start = 0; start + 3 <= 10; start++) {
+        const auto &slid = windowed.slideTo(adjList, start, start + 3);
+        auto scratch = adjList.pageRank(start, start + 3, options);
+        CHECK(std::fabs(sumOf(slid) - 1) < 1e-9);
+        CHECK(distance(slid, scratch) < 1e-9);
+    }
+    return 0;
+}
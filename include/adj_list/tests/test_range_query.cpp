@@ -0,0 +1,37 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <atomic>
+#include <thread>
+
+//callbacks of rangeQuery run after the timestamp was unlocked, so they can query and modify the graph
+int main() {
+    AdjList graph;
+    graph.applyBatch(true, {1, 2, 3}, {2, 3, 4}, {10, 10, 11});
+
+    uint64_t visited = 0;
+    graph.rangeQuery(0, 20, [&](uint64_t time, uint64_t source, uint64_t destination) {
+        CHECK(graph.findEdge(source, destination, time));
+        CHECK(graph.findEdge(destination, source, time));
+        visited++;
+    });
+    CHECK(visited == 6);
+
+    graph.rangeQuery(10, 11, [&](uint64_t time, uint64_t source, uint64_t destination) {
+        if (source < destination) graph.applyBatch(true, {source}, {destination}, {time + 5});
+    });
+    CHECK(graph.findEdge(1, 2, 15));
+    CHECK(graph.findEdge(2, 3, 15));
+    CHECK(!graph.findEdge(3, 4, 15));
+
+    //a slow callback does not block ingestion of the same timestamp
+    std::atomic<bool> inserted(false);
+    graph.rangeQuery(11, 12, [&](uint64_t time, uint64_t, uint64_t) {
+        if (inserted) return;
+        std::thread writer([&] { graph.applyBatch(true, {7}, {8}, {time}); });
+        writer.join();
+        inserted = true;
+    });
+    CHECK(graph.findEdge(7, 8, 11));
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <cstdint>
+
+int main() {
+    AdjList graph;
+    graph.setIncrementalComponents(true);
+    graph.setIncrementalTriangles(true);
+    graph.setIncrementalCores(true);
+    //keeps the timestamps newest - 2 to newest
+    graph.setRetentionWindow(3);
+
+    //triangle 1-2-3 and 3-4 at 0, 4-5 at 1, triangle 5-6-7 at 2 and 1-2 once more at 3. The batch ends at 3, so
+    //timestamp 0 is evicted right away and 1 is the oldest timestamp that is kept
+    graph.applyBatch(true, {1, 2, 1, 3, 4, 5, 6, 5, 1}, {2, 3, 3, 4, 5, 6, 7, 7, 2}, {0, 0, 0, 0, 1, 2, 2, 2, 3});
+    CHECK(!graph.findEdge(1, 2, 0) && !graph.findEdge(3, 4, 0));
+    CHECK(graph.findEdge(4, 5, 1) && graph.findEdge(1, 2, 3));
+    CHECK(graph.getVertexBitmap(0, 1).cardinality() == 0);
+
+    //1-2 survives through its occurrence at 3, 3 lost all its edges and is a singleton
+    CHECK(graph.getComponentCount() == 3);
+    CHECK(graph.getComponentId(1) == graph.getComponentId(2));
+    CHECK(graph.getComponentSize(3) == 1);
+    CHECK(graph.getComponentSize(4) == 4);
+    CHECK(graph.getTriangleCount() == 1);
+    CHECK(graph.getVertexTriangles(1) == 0 && graph.getVertexTriangles(5) == 1);
+    CHECK(graph.getCoreNumber(3) == 0 && graph.getCoreNumber(1) == 1 && graph.getCoreNumber(4) == 1);
+    CHECK(graph.getCoreNumber(6) == 2 && graph.getDegeneracy() == 2);
+
+    //7-8 at 5 moves the horizon to 3, which is kept while 1 and 2 are evicted
+    graph.applyBatch(true, {7}, {8}, {5});
+    CHECK(!graph.findEdge(4, 5, 1) && !graph.findEdge(5, 6, 2));
+    CHECK(graph.findEdge(1, 2, 3) && graph.findEdge(7, 8, 5));
+    CHECK(graph.getComponentCount() == 6);
+    CHECK(graph.getComponentId(7) == graph.getComponentId(8));
+    CHECK(graph.getComponentSize(5) == 1);
+    CHECK(graph.getTriangleCount() == 0);
+    CHECK(graph.getDegeneracy() == 1 && graph.getCoreNumber(5) == 0);
+
+    //the maintained values agree with computing them from the remaining edges
+    CHECK(graph.connectedComponents(0, UINT64_MAX).count == 2);
+    CHECK(graph.countTriangles(0, UINT64_MAX).total == 0);
+    CHECK(graph.coreDecomposition(0, UINT64_MAX).degeneracy == 1);
+
+    //an explicit eviction up to the oldest remaining timestamp evicts nothing, the next one only 3
+    CHECK(graph.evictBefore(3) == 0);
+    CHECK(graph.evictBefore(5) == 1);
+    CHECK(!graph.findEdge(1, 2, 3) && graph.findEdge(7, 8, 5));
+    CHECK(graph.getComponentCount() == 7);
+    CHECK(graph.getDegeneracy() == 1 && graph.getCoreNumber(1) == 0);
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "sharded_adj_list.h"
+#include "runtime_config.h"
+#include "check.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+typedef std::set<std::tuple<uint64_t, uint64_t, uint64_t>> EdgeSet;
+
+//every edge is found in both directions and the per timestamp and window counters add up over the shards
+void checkAgainstReference(ShardedAdjList &graph, const EdgeSet &reference, uint64_t times) {
+    std::vector<size_t> perTime(times, 0);
+    std::set<uint64_t> vertices;
+    for (const auto &[time, source, destination]: reference) {
+        CHECK(graph.findEdge(source, destination, time));
+        CHECK(graph.findEdge(destination, source, time));
+        perTime[time] += 2;
+        vertices.insert(source);
+        vertices.insert(destination);
+    }
+    for (uint64_t time = 0; time < times; time++) CHECK(graph.getEdgeCount(time) == perTime[time]);
+    CHECK(graph.getWindowStats(0, times).edges == 2 * reference.size());
+    auto bitmap = graph.getVertexBitmap(0, times).toSequence();
+    CHECK(std::vector<uint64_t>(bitmap.begin(), bitmap.end()) == std::vector<uint64_t>(vertices.begin(), vertices.end()));
+
+    //the export merges the vertex shards of every epoch back into (time, source) order
+    const char *path = "test_sharded_export.bin";
+    CHECK(graph.exportRange(0, times, path, ExportFormat::Binary) == reference.size());
+    FILE *file = std::fopen(path, "rb");
+    CHECK(file != nullptr);
+    EdgeSet exported;
+    uint64_t record[3];
+    uint64_t lastTime = 0, lastSource = 0;
+    while (std::fread(record, sizeof(uint64_t), 3, file) == 3) {
+        CHECK(record[2] > lastTime || (record[2] == lastTime && record[0] >= lastSource));
+        lastTime = record[2];
+        lastSource = record[0];
+        exported.emplace(record[2], record[0], record[1]);
+    }
+    std::fclose(file);
+    std::remove(path);
+    CHECK(exported == reference);
+}
+
+//inserts and deletes edges across epochs and checks after every batch that all of them were routed consistently
+void checkRouting() {
+    //3 vertex shards times 2 epoch shards with epochs of 4 time units, so epochs 0 and 2 share their shards
+    const uint64_t times = 12;
+    ShardedAdjList graph(3, 2, 4);
+    CHECK(graph.shardCount() == 6);
+
+    std::mt19937_64 random(28);
+    EdgeSet reference;
+    std::vector<uint64_t> sources, destinations, edgeTimes;
+    while (reference.size() < 2000) {
+        uint64_t a = random() % 300, b = random() % 300, time = random() % times;
+        if (a == b) continue;
+        if (!reference.emplace(time, std::min(a, b), std::max(a, b)).second) continue;
+        sources.push_back(a);
+        destinations.push_back(b);
+        edgeTimes.push_back(time);
+    }
+    graph.batchOperation(true, sources, destinations, edgeTimes);
+    checkAgainstReference(graph, reference, times);
+    CHECK(!graph.findEdge(1000, 1001, 0));
+
+    //deleting from one epoch leaves the same edges in the epoch that shares its shards untouched
+    sources.clear();
+    destinations.clear();
+    edgeTimes.clear();
+    for (auto it = reference.begin(); it != reference.end();) {
+        auto [time, source, destination] = *it;
+        if (time / 4 == 0 && source % 2 == 0) {
+            sources.push_back(destination);
+            destinations.push_back(source);
+            edgeTimes.push_back(time);
+            it = reference.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    graph.batchOperation(false, sources, destinations, edgeTimes);
+    checkAgainstReference(graph, reference, times);
+
+    //an edge at the same position of another epoch lands in a different timestamp of the same shards
+    graph.batchOperation(true, {7, 7}, {9, 9}, {1, 9});
+    reference.emplace(1, 7, 9);
+    reference.emplace(9, 7, 9);
+    graph.batchOperation(false, {9}, {7}, {1});
+    reference.erase({1, 7, 9});
+    checkAgainstReference(graph, reference, times);
+    CHECK(!graph.findEdge(7, 9, 1) && graph.findEdge(9, 7, 9));
+}
+
+}
+
+int main() {
+    checkRouting();
+    //with first touch every shard is allocated and applied by the worker that owns it
+    SchedulerConfig config;
+    config.numaFirstTouch = true;
+    configureScheduler(config);
+    checkRouting();
+    return 0;
+}
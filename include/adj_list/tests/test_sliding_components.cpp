@@ -0,0 +1,74 @@
+#include "adj_list.h"
+#include "sliding_components.h"
+#include "check.h"
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+//the window [end - window, end) has to have the same components as a full computation over that range
+void checkAgainstFullComputation(AdjList &graph, SlidingWindowComponents &sliding, uint64_t start, uint64_t end) {
+    auto components = graph.computeComponents(start, end);
+    CHECK(sliding.getComponentCount() == components.size());
+    std::set<uint64_t> representatives;
+    auto table = components.lock_table();
+    for (const auto &component: table) {
+        uint64_t representative = sliding.componentOf(component.second.front());
+        for (uint64_t vertex: component.second) CHECK(sliding.componentOf(vertex) == representative);
+        //different components of the full computation are different components of the window
+        CHECK(representatives.insert(representative).second);
+    }
+}
+
+}
+
+int main() {
+    {
+        //1-3 closes the cycle 1-2-3 and replaces the older 1-2, so 1-2 expires without splitting the component
+        AdjList graph;
+        graph.applyBatch(true, {1, 2, 1}, {2, 3, 3}, {0, 1, 2});
+        SlidingWindowComponents sliding(2);
+        sliding.slideTo(graph, 2);
+        CHECK(sliding.connected(1, 3) && sliding.getComponentCount() == 1);
+        sliding.slideTo(graph, 3);
+        CHECK(sliding.getEdgeCount() == 2);
+        CHECK(sliding.connected(1, 2) && sliding.connected(2, 3));
+        sliding.slideTo(graph, 4);
+        CHECK(sliding.getEdgeCount() == 1);
+        CHECK(sliding.connected(1, 3) && !sliding.connected(1, 2));
+        CHECK(sliding.getComponentCount() == 1);
+        sliding.slideTo(graph, 5);
+        CHECK(sliding.getEdgeCount() == 0 && sliding.getComponentCount() == 0);
+    }
+
+    //timestamps arrive one or a few at a time, the window slides over them and old timestamps are evicted
+    const uint64_t window = 4;
+    const uint64_t vertices = 60;
+    std::mt19937_64 random(43);
+    AdjList graph;
+    SlidingWindowComponents sliding(window);
+    uint64_t end = 0;
+    while (end < 24) {
+        uint64_t arriving = 1 + random() % 3;
+        std::vector<uint64_t> sources, destinations, times;
+        for (uint64_t time = end; time < end + arriving; time++) {
+            for (int i = 0; i < 25; i++) {
+                uint64_t a = random() % vertices, b = random() % vertices;
+                if (a == b) continue;
+                sources.push_back(a);
+                destinations.push_back(b);
+                times.push_back(time);
+            }
+        }
+        graph.applyBatch(true, sources, destinations, times);
+        end += arriving;
+        sliding.slideTo(graph, end);
+        uint64_t start = end > window ? end - window : 0;
+        checkAgainstFullComputation(graph, sliding, start, end);
+        graph.evictBefore(start);
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+//number of edges of the pinned version at every timestamp
+uint64_t countEdges(const Snapshot &snapshot) {
+    uint64_t edges = 0;
+    snapshot.visitRange(0, UINT64_MAX, [&](uint64_t, uint64_t, DestinationSpan destinations) {
+        edges += destinations.size();
+    });
+    return edges;
+}
+
+}
+
+int main() {
+    AdjList graph;
+    graph.applyBatch(true, {1, 1, 2}, {2, 3, 3}, {5, 5, 6});
+    graph.setSnapshotIsolation(true);
+
+    auto first = graph.pinSnapshot();
+    CHECK(first && first->getSize() == 2);
+    CHECK(first->findEdge(1, 2, 5) && first->findEdge(2, 1, 5));
+    CHECK(first->getEdgeCount(5) == 4);
+
+    //a batch only copies the rows it touched, the others are shared with the previous version
+    graph.applyBatch(true, {1}, {4}, {5});
+    auto second = graph.pinSnapshot();
+    CHECK(second->getVersion() == first->getVersion() + 1);
+    CHECK(second->findEdge(1, 4, 5) && second->findEdge(4, 1, 5));
+    CHECK(!first->findEdge(1, 4, 5));
+    CHECK(second->getEdgeCount(5) == 6);
+    CHECK(second->getPartition(6) == first->getPartition(6));
+    const SnapshotPartition &before = *first->getPartition(5);
+    const SnapshotPartition &after = *second->getPartition(5);
+    auto rowOf = [](const SnapshotPartition &p, uint64_t source) {
+        return p.rows[std::lower_bound(p.sources.begin(), p.sources.end(), source) - p.sources.begin()];
+    };
+    CHECK(rowOf(before, 2) == rowOf(after, 2));
+    CHECK(rowOf(before, 3) == rowOf(after, 3));
+    CHECK(rowOf(before, 1) != rowOf(after, 1));
+
+    //deleting the last edges of a source or a timestamp drops them from the next version
+    graph.applyBatch(false, {1, 2}, {4, 3}, {5, 6});
+    auto third = graph.pinSnapshot();
+    CHECK(third->getEdgeCount(5) == 4);
+    CHECK(third->getPartition(5)->neighbours(4).size() == 0);
+    CHECK(third->getSize() == 1);
+    CHECK(second->findEdge(2, 3, 6));
+
+    graph.evictBefore(6);
+    CHECK(graph.pinSnapshot()->getSize() == 0);
+    CHECK(third->getSize() == 1);
+
+    //readers running next to the batches only ever see versions after complete batches, every batch adds 10
+    //undirected edges
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> checked(0);
+    std::thread reader([&] {
+        while (!done) {
+            auto snapshot = graph.pinSnapshot();
+            CHECK(countEdges(*snapshot) % 20 == 0);
+            checked++;
+        }
+    });
+    for (uint64_t batch = 0; batch < 50; batch++) {
+        std::vector<uint64_t> sources, destinations, times;
+        for (uint64_t i = 0; i < 10; i++) {
+            sources.push_back(1000 + batch * 10 + i);
+            destinations.push_back(i);
+            times.push_back(100 + i % 3);
+        }
+        graph.applyBatch(true, sources, destinations, times);
+    }
+    done = true;
+    reader.join();
+    CHECK(checked > 0);
+    CHECK(countEdges(*graph.pinSnapshot()) == 50 * 20);
+    return 0;
+}
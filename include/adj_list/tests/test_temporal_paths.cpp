@@ -0,0 +1,58 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <cstdint>
+#include <vector>
+
+int main() {
+    const uint64_t unreached = UINT64_MAX;
+    //1-2 at 1, 2-3 at 2, 3-4 at 2 and 3, 1-4 at 4, 4-5 at 5 and the separate 6-7 at 0. A hop of timestamp t arrives
+    //at t + 1, so 3-4 at 2 can not continue 2-3 at 2
+    AdjList graph;
+    graph.applyBatch(true, {1, 2, 3, 3, 1, 4, 6}, {2, 3, 4, 4, 4, 5, 7}, {1, 2, 2, 3, 4, 5, 0});
+
+    auto arrival = graph.earliestArrival(1, 0, 10);
+    CHECK(arrival.valueOf(1) == 0);
+    CHECK(arrival.valueOf(2) == 2);
+    CHECK(arrival.valueOf(3) == 3);
+    CHECK(arrival.valueOf(4) == 4);
+    CHECK(arrival.valueOf(5) == 6);
+    CHECK(arrival.valueOf(6) == unreached && arrival.valueOf(7) == unreached);
+
+    //the range ends before 4-5 or starts after 1-2, and a source without edges in the range reaches nothing
+    CHECK(graph.earliestArrival(1, 0, 5).valueOf(5) == unreached);
+    auto late = graph.earliestArrival(1, 2, 10);
+    CHECK(late.valueOf(1) == 2 && late.valueOf(4) == 5 && late.valueOf(5) == 6);
+    CHECK(late.valueOf(2) == unreached && late.valueOf(3) == unreached);
+    auto isolated = graph.earliestArrival(2, 3, 10);
+    for (uint64_t value: isolated.values) CHECK(value == unreached);
+
+    auto departure = graph.latestDeparture(5, 0, 10);
+    CHECK(departure.valueOf(5) == 10);
+    CHECK(departure.valueOf(4) == 5);
+    CHECK(departure.valueOf(3) == 3);
+    CHECK(departure.valueOf(2) == 2);
+    CHECK(departure.valueOf(1) == 4);
+    CHECK(departure.valueOf(6) == unreached && departure.valueOf(7) == unreached);
+    //4-5 at 5 can not be followed by anything of the same timestamp
+    CHECK(graph.latestDeparture(4, 0, 10).valueOf(5) == 5);
+
+    //4 is reached fastest by leaving 1 at 4, not by the earlier path over 2 and 3
+    auto fastest = graph.fastestPaths(1, 0, 10);
+    CHECK(fastest.valueOf(1) == 0);
+    CHECK(fastest.valueOf(2) == 1);
+    CHECK(fastest.valueOf(3) == 2);
+    CHECK(fastest.valueOf(4) == 1);
+    CHECK(fastest.valueOf(5) == 2);
+    CHECK(fastest.valueOf(7) == unreached);
+
+    //the sources are 1, 6, 5 and 99, which has no edge
+    auto arrivals = graph.earliestArrivals({1, 6, 5, 99}, 0, 10);
+    for (uint64_t vertex: arrival.vertices) CHECK(arrivals.arrivalOf(0, vertex) == arrival.valueOf(vertex));
+    CHECK(arrivals.arrivalOf(1, 6) == 0 && arrivals.arrivalOf(1, 7) == 1 && arrivals.arrivalOf(1, 1) == unreached);
+    CHECK(arrivals.arrivalOf(2, 5) == 0 && arrivals.arrivalOf(2, 4) == 6 && arrivals.arrivalOf(2, 3) == unreached);
+    for (uint64_t vertex: arrival.vertices) CHECK(arrivals.arrivalOf(3, vertex) == unreached);
+    CHECK(arrivals.reachable(0) == parlay::sequence<uint64_t>({1, 2, 3, 4, 5}));
+    CHECK(graph.temporalReachable(6, 0, 10) == parlay::sequence<uint64_t>({6, 7}));
+    return 0;
+}
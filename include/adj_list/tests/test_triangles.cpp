@@ -0,0 +1,80 @@
+#include "adj_list.h"
+#include "check.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+//the maintained counts have to match a full recount of the whole graph
+void checkAgainstRecount(AdjList &graph) {
+    auto counts = graph.countTriangles(0, UINT64_MAX);
+    CHECK(counts.total == graph.getTriangleCount());
+    for (size_t i = 0; i < counts.vertices.size(); i++) {
+        CHECK(counts.triangles[i] == graph.getVertexTriangles(counts.vertices[i]));
+    }
+}
+
+}
+
+int main() {
+    AdjList graph;
+    graph.setIncrementalTriangles(true);
+
+    //the edge 1-3 exists at two timestamps, the triangle is only gone once both are deleted
+    graph.applyBatch(true, {1, 2, 1, 3}, {2, 3, 3, 1}, {1, 1, 1, 2});
+    CHECK(graph.getTriangleCount() == 1);
+    CHECK(graph.getVertexTriangles(2) == 1);
+    graph.applyBatch(false, {1}, {3}, {1});
+    CHECK(graph.getTriangleCount() == 1);
+    graph.applyBatch(false, {3}, {1}, {2});
+    CHECK(graph.getTriangleCount() == 0);
+    CHECK(graph.getVertexTriangles(2) == 0);
+    checkAgainstRecount(graph);
+
+    std::mt19937_64 random(21);
+    const uint64_t vertices = 150;
+    for (int round = 0; round < 15; round++) {
+        //inserts with some edges in both directions and some that already exist
+        std::vector<uint64_t> sources, destinations, times;
+        for (int i = 0; i < 300; i++) {
+            uint64_t a = random() % vertices, b = random() % vertices, time = random() % 6;
+            sources.push_back(a);
+            destinations.push_back(b);
+            times.push_back(time);
+            if (i % 5 == 0) {
+                sources.push_back(b);
+                destinations.push_back(a);
+                times.push_back(time);
+            }
+        }
+        graph.applyBatch(true, sources, destinations, times);
+        checkAgainstRecount(graph);
+
+        //deletes every fourth edge plus some edges that do not exist
+        sources.clear();
+        destinations.clear();
+        times.clear();
+        uint64_t visited = 0;
+        graph.rangeQuery(0, UINT64_MAX, [&](uint64_t time, uint64_t source, uint64_t destination) {
+            if (visited++ % 4 != 0) return;
+            sources.push_back(source);
+            destinations.push_back(destination);
+            times.push_back(time);
+        });
+        for (int i = 0; i < 20; i++) {
+            sources.push_back(random() % vertices);
+            destinations.push_back(random() % vertices);
+            times.push_back(random() % 6);
+        }
+        graph.applyBatch(false, sources, destinations, times);
+        checkAgainstRecount(graph);
+
+        if (round == 7) {
+            graph.evictBefore(2);
+            checkAgainstRecount(graph);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,294 @@
+#include "triangles.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * Calls @p onMatch for every element that is in both sorted lists, the lists must not contain duplicates.
+ * With AVX2 blocks of four elements of both lists are compared all against all with three rotations, the block
+ * with the smaller last element is skipped afterwards. The rest is merged one element at a time.
+ * @param a sorted list
+ * @param b sorted list
+ * @param onMatch called with each common element in ascending order
+ */
+template<typename F>
+void intersectSorted(NeighbourSpan a, NeighbourSpan b, F &&onMatch) {
+    size_t i = 0;
+    size_t j = 0;
+#ifdef __AVX2__
+    while (i + 4 <= a.size() && j + 4 <= b.size()) {
+        __m256i blockA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.begin() + i));
+        __m256i blockB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.begin() + j));
+        __m256i equal = _mm256_cmpeq_epi64(blockA, blockB);
+        equal = _mm256_or_si256(equal, _mm256_cmpeq_epi64(blockA, _mm256_permute4x64_epi64(blockB, 0x39)));
+        equal = _mm256_or_si256(equal, _mm256_cmpeq_epi64(blockA, _mm256_permute4x64_epi64(blockB, 0x4e)));
+        equal = _mm256_or_si256(equal, _mm256_cmpeq_epi64(blockA, _mm256_permute4x64_epi64(blockB, 0x93)));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(equal));
+        while (mask != 0) {
+            onMatch(a[i + __builtin_ctz(mask)]);
+            mask &= mask - 1;
+        }
+        uint64_t lastA = a[i + 3];
+        uint64_t lastB = b[j + 3];
+        if (lastA <= lastB) i += 4;
+        if (lastB <= lastA) j += 4;
+    }
+#endif
+    while (i < a.size() && j < b.size()) {
+        if (a[i] == b[j]) {
+            onMatch(a[i]);
+            i++;
+            j++;
+        } else if (a[i] < b[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+}
+
+/**
+ * Edges of a WindowGraph directed from the endpoint with the smaller (degree, index) to the other one, which leaves
+ * every vertex with O(sqrt(m)) outgoing edges. Outgoing lists are sorted by index.
+ */
+struct OrientedGraph{
+    parlay::sequence<uint64_t> offsets;
+    parlay::sequence<uint64_t> outgoing;
+
+    explicit OrientedGraph(const WindowGraph &graph) {
+        size_t n = graph.numVertices();
+        auto before = [&](uint64_t u, uint64_t v) {
+            return graph.degree(u) < graph.degree(v) || (graph.degree(u) == graph.degree(v) && u < v);
+        };
+        offsets = parlay::tabulate(n + 1, [&](size_t u) -> uint64_t {
+            if (u == n) return 0;
+            auto neighbours = graph.neighbours(u);
+            return std::count_if(neighbours.begin(), neighbours.end(), [&](uint64_t v) { return before(u, v); });
+        });
+        uint64_t directedEdges = parlay::scan_inplace(offsets);
+        offsets[n] = directedEdges;
+        outgoing = parlay::sequence<uint64_t>(directedEdges);
+        parlay::parallel_for(0, n, [&](size_t u) {
+            uint64_t position = offsets[u];
+            for (uint64_t v: graph.neighbours(u)) {
+                if (before(u, v)) outgoing[position++] = v;
+            }
+        });
+    }
+
+    NeighbourSpan out(uint64_t u) const {
+        return NeighbourSpan(outgoing.data() + offsets[u], outgoing.data() + offsets[u + 1]);
+    }
+};
+
+}
+
+/**
+ * @param vertex
+ * @return number of triangles @p vertex is part of, 0 if it has no edge in the window
+ */
+uint64_t TriangleCounts::trianglesOf(uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return 0;
+    return triangles[it - vertices.begin()];
+}
+
+/**
+ * @param vertex
+ * @return local clustering coefficient of @p vertex, 0 if it has no edge in the window
+ */
+double TriangleCounts::clusteringOf(uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return 0;
+    return clustering[it - vertices.begin()];
+}
+
+/**
+ * Degree ordered triangle counting on the OrientedGraph. A triangle is found exactly once, as the intersection of the
+ * outgoing lists of both endpoints of its lowest ranked edge. Vertices are processed in
+ * parallel, the counts of the two endpoints are added once per edge, the third vertex is counted per match.
+ * @param graph window to count
+ * @return triangles and clustering coefficients of all vertices of @p graph
+ */
+TriangleCounts countTriangles(const WindowGraph &graph) {
+    size_t n = graph.numVertices();
+    TriangleCounts counts;
+    counts.vertices = graph.getVertices();
+
+    OrientedGraph oriented(graph);
+
+    std::vector<std::atomic<uint64_t>> perVertex(n);
+    parlay::parallel_for(0, n, [&](size_t i) { perVertex[i].store(0, std::memory_order_relaxed); });
+    auto found = parlay::tabulate(n, [&](size_t u) -> uint64_t {
+        uint64_t ofU = 0;
+        for (uint64_t v: oriented.out(u)) {
+            uint64_t ofEdge = 0;
+            intersectSorted(oriented.out(u), oriented.out(v), [&](uint64_t w) {
+                perVertex[w].fetch_add(1, std::memory_order_relaxed);
+                ofEdge++;
+            });
+            if (ofEdge > 0) perVertex[v].fetch_add(ofEdge, std::memory_order_relaxed);
+            ofU += ofEdge;
+        }
+        if (ofU > 0) perVertex[u].fetch_add(ofU, std::memory_order_relaxed);
+        return ofU;
+    }, 1);
+    counts.total = parlay::reduce(found);
+
+    counts.triangles = parlay::tabulate(n, [&](size_t i) { return perVertex[i].load(); });
+    counts.clustering = parlay::tabulate(n, [&](size_t i) {
+        double degree = graph.degree(i);
+        return degree < 2 ? 0.0 : 2.0 * counts.triangles[i] / (degree * (degree - 1));
+    });
+    uint64_t wedges = parlay::reduce(parlay::delayed_tabulate(n, [&](size_t i) -> uint64_t {
+        uint64_t degree = graph.degree(i);
+        return degree * (degree - 1) / 2;
+    }));
+    counts.transitivity = wedges == 0 ? 0.0 : 3.0 * counts.total / wedges;
+    return counts;
+}
+
+/**
+ * Enumerates every triangle of @p graph once, with the same degree ordering as countTriangles, and sums up the
+ * values @p f returns for them. @p f is called in parallel.
+ * @param graph
+ * @param f called with the indices of the three vertices of a triangle
+ * @return sum of all results of @p f
+ */
+uint64_t sumOverTriangles(const WindowGraph &graph, const std::function<uint64_t(uint64_t, uint64_t, uint64_t)> &f) {
+    OrientedGraph oriented(graph);
+    auto sums = parlay::tabulate(graph.numVertices(), [&](size_t u) -> uint64_t {
+        uint64_t sum = 0;
+        for (uint64_t v: oriented.out(u)) {
+            intersectSorted(oriented.out(u), oriented.out(v), [&](uint64_t w) { sum += f(u, v, w); });
+        }
+        return sum;
+    }, 1);
+    return parlay::reduce(sums);
+}
+
+void IncrementalTriangles::clear() {
+    adjacency.clear();
+    perVertex.clear();
+    total = 0;
+}
+
+/**
+ * Adds one timestamp to every pair. Pairs whose edge is new to the simple graph are inserted first, afterwards the
+ * triangles they close are searched in the updated graph.
+ * @param pairs edges as vertex pairs, once per timestamp that gained the edge
+ */
+void IncrementalTriangles::addOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    parlay::sequence<std::pair<uint64_t, uint64_t>> inserted;
+    for (const auto &[pair, occurrences]: countOccurrences(pairs)) {
+        uint64_t &multiplicity = adjacency[pair.first][pair.second];
+        if (multiplicity == 0) inserted.push_back(pair);
+        multiplicity += occurrences;
+        adjacency[pair.second][pair.first] += occurrences;
+    }
+    updateCounts(trianglesOfEdges(inserted), true);
+}
+
+/**
+ * Removes one timestamp from every pair. The triangles of the edges that leave the simple graph are searched while
+ * they are still part of it, only then the edges are erased.
+ * @param pairs edges as vertex pairs, once per timestamp that lost the edge
+ */
+void IncrementalTriangles::removeOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    parlay::sequence<std::pair<uint64_t, uint64_t>> removed;
+    for (const auto &[pair, occurrences]: countOccurrences(pairs)) {
+        auto it = adjacency.find(pair.first);
+        if (it == adjacency.end()) continue;
+        auto edge = it->second.find(pair.second);
+        if (edge == it->second.end()) continue;
+        uint64_t remaining = edge->second - std::min(edge->second, occurrences);
+        edge->second = remaining;
+        adjacency[pair.second][pair.first] = remaining;
+        if (remaining == 0) removed.push_back(pair);
+    }
+    updateCounts(trianglesOfEdges(removed), false);
+
+    for (const auto &pair: removed) {
+        for (auto [a, b]: {pair, std::make_pair(pair.second, pair.first)}) {
+            auto it = adjacency.find(a);
+            it->second.erase(b);
+            if (it->second.empty()) adjacency.erase(it);
+        }
+    }
+}
+
+/**
+ * @return number of triangles in the simple graph
+ */
+uint64_t IncrementalTriangles::count() const {
+    return total;
+}
+
+/**
+ * @param vertex
+ * @return number of triangles @p vertex is part of
+ */
+uint64_t IncrementalTriangles::trianglesOf(uint64_t vertex) const {
+    auto it = perVertex.find(vertex);
+    return it == perVertex.end() ? 0 : it->second;
+}
+
+/**
+ * Finds every triangle that contains at least one of the changed edges. Each edge probes the neighbours of its
+ * endpoint with fewer neighbours in the neighbourhood of the other endpoint, the edges are processed in parallel
+ * and only read the adjacency.
+ * @param changed sorted distinct pairs with the smaller vertex first, all of them part of the adjacency
+ * @return every such triangle exactly once
+ */
+parlay::sequence<std::array<uint64_t, 3>>
+IncrementalTriangles::trianglesOfEdges(const parlay::sequence<std::pair<uint64_t, uint64_t>> &changed) const {
+    auto isChanged = [&](uint64_t a, uint64_t b) {
+        return std::binary_search(changed.begin(), changed.end(), std::make_pair(std::min(a, b), std::max(a, b)));
+    };
+    auto perEdge = parlay::tabulate(changed.size(), [&](size_t i) {
+        auto [u, v] = changed[i];
+        const auto &ofU = adjacency.at(u);
+        const auto &ofV = adjacency.at(v);
+        const auto &smaller = ofU.size() <= ofV.size() ? ofU : ofV;
+        const auto &larger = ofU.size() <= ofV.size() ? ofV : ofU;
+        parlay::sequence<std::array<uint64_t, 3>> found;
+        for (const auto &neighbour: smaller) {
+            uint64_t w = neighbour.first;
+            if (w == u || w == v || larger.find(w) == larger.end()) continue;
+            //a triangle with several changed edges belongs to the smallest of them
+            auto uw = std::make_pair(std::min(u, w), std::max(u, w));
+            auto vw = std::make_pair(std::min(v, w), std::max(v, w));
+            if ((uw < changed[i] && isChanged(u, w)) || (vw < changed[i] && isChanged(v, w))) continue;
+            found.push_back({u, v, w});
+        }
+        return found;
+    }, 1);
+    return parlay::flatten(perEdge);
+}
+
+/**
+ * @param triangles triangles that were closed or opened
+ * @param add whether they were closed
+ */
+void IncrementalTriangles::updateCounts(const parlay::sequence<std::array<uint64_t, 3>> &triangles, bool add) {
+    for (const auto &triangle: triangles) {
+        for (uint64_t vertex: triangle) {
+            if (add) {
+                perVertex[vertex]++;
+            } else {
+                auto it = perVertex.find(vertex);
+                if (--it->second == 0) perVertex.erase(it);
+            }
+        }
+    }
+    if (add) total += triangles.size();
+    else total -= triangles.size();
+}
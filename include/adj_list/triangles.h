@@ -0,0 +1,58 @@
+#ifndef TEMPUS_TRIANGLES_H
+#define TEMPUS_TRIANGLES_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include "parlay/sequence.h"
+#include "window_graph.h"
+
+/**
+ * Triangles of a window. @p triangles[i] and @p clustering[i] belong to @p vertices[i]. The local clustering
+ * coefficient is the share of neighbour pairs of a vertex that are connected, 0 for vertices with fewer than two
+ * neighbours. The transitivity is three times the number of triangles divided by the number of wedges.
+ */
+struct TriangleCounts{
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<uint64_t> triangles;
+    parlay::sequence<double> clustering;
+    uint64_t total = 0;
+    double transitivity = 0;
+
+    uint64_t trianglesOf(uint64_t vertex) const;
+    double clusteringOf(uint64_t vertex) const;
+};
+
+TriangleCounts countTriangles(const WindowGraph &graph);
+uint64_t sumOverTriangles(const WindowGraph &graph, const std::function<uint64_t(uint64_t, uint64_t, uint64_t)> &f);
+
+/**
+ * Triangles of the simple graph that contains every edge of any timestamp, maintained under batches. Every edge
+ * keeps the number of timestamps that contain it and only enters or leaves the simple graph when that number
+ * changes from or to 0. The triangles of a batch are found by intersecting the neighbourhoods of its changed edges
+ * in parallel, a triangle with several changed edges is only counted by the smallest of them.
+ * Not thread safe, the owner serializes all calls.
+ */
+class IncrementalTriangles{
+public:
+    void clear();
+    void addOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    void removeOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    uint64_t count() const;
+    uint64_t trianglesOf(uint64_t vertex) const;
+
+private:
+    //vertex < neighbour < number of timestamps that contain the edge>>
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, uint64_t>> adjacency;
+    //vertex < triangles it is part of>, vertices without triangles are not stored
+    std::unordered_map<uint64_t, uint64_t> perVertex;
+    uint64_t total = 0;
+
+    parlay::sequence<std::array<uint64_t, 3>>
+    trianglesOfEdges(const parlay::sequence<std::pair<uint64_t, uint64_t>> &changed) const;
+    void updateCounts(const parlay::sequence<std::array<uint64_t, 3>> &triangles, bool add);
+};
+
+#endif //TEMPUS_TRIANGLES_H
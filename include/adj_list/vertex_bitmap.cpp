@@ -0,0 +1,231 @@
+#include "vertex_bitmap.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+
+/**
+ * Inserts @p low into the container, converting it into a bitmap once it gets too dense.
+ * @param low lower 16 bits of the vertex id
+ * @return true if the value was not present before
+ */
+bool VertexBitmap::Container::add(uint16_t low) {
+    if (isBitmap()) {
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (bits[low >> 6] & mask) return false;
+        bits[low >> 6] |= mask;
+        cardinality++;
+        return true;
+    }
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) return false;
+    array.insert(it, low);
+    cardinality++;
+    if (cardinality > arrayLimit) toBitmap();
+    return true;
+}
+
+/**
+ * Removes @p low from the container, converting it back into an array once it gets sparse.
+ * @param low lower 16 bits of the vertex id
+ * @return true if the value was present
+ */
+bool VertexBitmap::Container::remove(uint16_t low) {
+    if (isBitmap()) {
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (!(bits[low >> 6] & mask)) return false;
+        bits[low >> 6] &= ~mask;
+        cardinality--;
+        if (cardinality <= arrayLimit / 2) toArray();
+        return true;
+    }
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it == array.end() || *it != low) return false;
+    array.erase(it);
+    cardinality--;
+    return true;
+}
+
+bool VertexBitmap::Container::contains(uint16_t low) const {
+    if (isBitmap()) return bits[low >> 6] & (uint64_t{1} << (low & 63));
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+/**
+ * Merges @p other into this container. Two arrays are merged as sorted lists, anything else as a bitwise OR.
+ * @param other container with the same high key
+ */
+void VertexBitmap::Container::unionWith(const Container &other) {
+    if (!isBitmap() && !other.isBitmap()) {
+        std::vector<uint16_t> merged;
+        merged.reserve(array.size() + other.array.size());
+        std::set_union(array.begin(), array.end(), other.array.begin(), other.array.end(),
+                       std::back_inserter(merged));
+        array.swap(merged);
+        cardinality = array.size();
+        if (cardinality > arrayLimit) toBitmap();
+        return;
+    }
+    if (!isBitmap()) toBitmap();
+    if (other.isBitmap()) {
+        for (uint32_t i = 0; i < bitmapWords; i++) bits[i] |= other.bits[i];
+    } else {
+        for (uint16_t low: other.array) bits[low >> 6] |= uint64_t{1} << (low & 63);
+    }
+    cardinality = 0;
+    for (uint64_t word: bits) cardinality += __builtin_popcountll(word);
+}
+
+void VertexBitmap::Container::toBitmap() {
+    bits.assign(bitmapWords, 0);
+    for (uint16_t low: array) bits[low >> 6] |= uint64_t{1} << (low & 63);
+    std::vector<uint16_t>().swap(array);
+}
+
+void VertexBitmap::Container::toArray() {
+    array.clear();
+    array.reserve(cardinality);
+    for (uint32_t i = 0; i < bitmapWords; i++) {
+        uint64_t word = bits[i];
+        while (word) {
+            array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    std::vector<uint64_t>().swap(bits);
+}
+
+/**
+ * @param key high 48 bits of a vertex id
+ * @return position of @p key in keys or keys.size() if it is not present
+ */
+size_t VertexBitmap::findKey(uint64_t key) const {
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) return keys.size();
+    return it - keys.begin();
+}
+
+void VertexBitmap::add(uint64_t vertex) {
+    uint64_t key = vertex >> 16;
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    size_t i = it - keys.begin();
+    if (it == keys.end() || *it != key) {
+        keys.insert(it, key);
+        containers.insert(containers.begin() + i, Container{});
+    }
+    containers[i].add(static_cast<uint16_t>(vertex));
+}
+
+void VertexBitmap::remove(uint64_t vertex) {
+    size_t i = findKey(vertex >> 16);
+    if (i == keys.size()) return;
+    containers[i].remove(static_cast<uint16_t>(vertex));
+    if (containers[i].cardinality == 0) {
+        keys.erase(keys.begin() + i);
+        containers.erase(containers.begin() + i);
+    }
+}
+
+bool VertexBitmap::contains(uint64_t vertex) const {
+    size_t i = findKey(vertex >> 16);
+    return i != keys.size() && containers[i].contains(static_cast<uint16_t>(vertex));
+}
+
+bool VertexBitmap::empty() const {
+    return keys.empty();
+}
+
+uint64_t VertexBitmap::cardinality() const {
+    uint64_t count = 0;
+    for (const auto &c: containers) count += c.cardinality;
+    return count;
+}
+
+/**
+ * @return bytes held by the keys and containers
+ */
+size_t VertexBitmap::memoryUsage() const {
+    size_t memory = keys.capacity() * sizeof(uint64_t) + containers.capacity() * sizeof(Container);
+    for (const auto &c: containers) {
+        memory += c.array.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+    }
+    return memory;
+}
+
+/**
+ * Merges @p other into this bitmap by walking both key lists in order.
+ * @param other
+ */
+void VertexBitmap::unionWith(const VertexBitmap &other) {
+    std::vector<uint64_t> mergedKeys;
+    std::vector<Container> mergedContainers;
+    mergedKeys.reserve(keys.size() + other.keys.size());
+    mergedContainers.reserve(keys.size() + other.keys.size());
+
+    size_t i = 0, j = 0;
+    while (i < keys.size() || j < other.keys.size()) {
+        if (j == other.keys.size() || (i < keys.size() && keys[i] < other.keys[j])) {
+            mergedKeys.push_back(keys[i]);
+            mergedContainers.push_back(std::move(containers[i++]));
+        } else if (i == keys.size() || other.keys[j] < keys[i]) {
+            mergedKeys.push_back(other.keys[j]);
+            mergedContainers.push_back(other.containers[j++]);
+        } else {
+            mergedKeys.push_back(keys[i]);
+            mergedContainers.push_back(std::move(containers[i++]));
+            mergedContainers.back().unionWith(other.containers[j++]);
+        }
+    }
+    keys.swap(mergedKeys);
+    containers.swap(mergedContainers);
+}
+
+/**
+ * Expands the bitmap into a sorted sequence of vertex ids. Containers are expanded in parallel.
+ * @return sorted vertex ids
+ */
+parlay::sequence<uint64_t> VertexBitmap::toSequence() const {
+    auto sizes = parlay::tabulate(containers.size(), [&](size_t i) {
+        return static_cast<uint64_t>(containers[i].cardinality);
+    });
+    uint64_t total = parlay::scan_inplace(sizes);
+    parlay::sequence<uint64_t> vertices(total);
+
+    parlay::parallel_for(0, containers.size(), [&](size_t i) {
+        const Container &c = containers[i];
+        uint64_t high = keys[i] << 16;
+        uint64_t pos = sizes[i];
+        if (c.isBitmap()) {
+            for (uint32_t w = 0; w < bitmapWords; w++) {
+                uint64_t word = c.bits[w];
+                while (word) {
+                    vertices[pos++] = high | (w * 64 + __builtin_ctzll(word));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (uint16_t low: c.array) vertices[pos++] = high | low;
+        }
+    }, 1);
+    return vertices;
+}
+
+/**
+ * Computes the union of all given bitmaps as a parallel tree reduction.
+ * @param bitmaps bitmaps to be merged, must not be modified during the call
+ * @return union of @p bitmaps
+ */
+VertexBitmap VertexBitmap::unionAll(const std::vector<const VertexBitmap*> &bitmaps) {
+    if (bitmaps.empty()) return {};
+    return unionRange(bitmaps, 0, bitmaps.size());
+}
+
+VertexBitmap VertexBitmap::unionRange(const std::vector<const VertexBitmap*> &bitmaps, size_t from, size_t to) {
+    if (to - from == 1) return *bitmaps[from];
+    size_t mid = from + (to - from) / 2;
+    VertexBitmap left, right;
+    parlay::par_do([&]() { left = unionRange(bitmaps, from, mid); },
+                   [&]() { right = unionRange(bitmaps, mid, to); });
+    left.unionWith(right);
+    return left;
+}
@@ -0,0 +1,52 @@
+#ifndef TEMPUS_VERTEX_BITMAP_H
+#define TEMPUS_VERTEX_BITMAP_H
+
+#include <cstdint>
+#include <vector>
+#include "parlay/sequence.h"
+
+/**
+ * Compressed set of vertex ids in the style of a roaring bitmap.
+ * Ids are split into a 48 bit key and a 16 bit low part. Every key owns a container that is either a sorted array
+ * (sparse) or a 65536 bit bitmap (dense).
+ */
+class VertexBitmap{
+public:
+    void add(uint64_t vertex);
+    void remove(uint64_t vertex);
+    bool contains(uint64_t vertex) const;
+    bool empty() const;
+    uint64_t cardinality() const;
+    size_t memoryUsage() const;
+    void unionWith(const VertexBitmap &other);
+    parlay::sequence<uint64_t> toSequence() const;
+    static VertexBitmap unionAll(const std::vector<const VertexBitmap*> &bitmaps);
+
+private:
+    //containers with more entries than this are stored as bitmaps
+    static constexpr uint32_t arrayLimit = 4096;
+    static constexpr uint32_t bitmapWords = 1024;
+
+    struct Container{
+        std::vector<uint16_t> array;
+        std::vector<uint64_t> bits;
+        uint32_t cardinality = 0;
+
+        bool isBitmap() const { return !bits.empty(); }
+        bool add(uint16_t low);
+        bool remove(uint16_t low);
+        bool contains(uint16_t low) const;
+        void unionWith(const Container &other);
+        void toBitmap();
+        void toArray();
+    };
+
+    //sorted high keys, containers[i] belongs to keys[i]
+    std::vector<uint64_t> keys;
+    std::vector<Container> containers;
+
+    size_t findKey(uint64_t key) const;
+    static VertexBitmap unionRange(const std::vector<const VertexBitmap*> &bitmaps, size_t from, size_t to);
+};
+
+#endif //TEMPUS_VERTEX_BITMAP_H
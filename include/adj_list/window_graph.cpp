@@ -0,0 +1,192 @@
+#include "window_graph.h"
+#include "parlay/parallel.h"
+#include "parlay/primitives.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+/**
+ * Builds the CSR arrays. Both directions of every pair are mapped to vertex indices and sorted, the offsets are
+ * found by binary search in the sorted sources.
+ * @param vertices sorted ids of all vertices that appear in @p pairs, isolated vertices may be included
+ * @param pairs undirected edges without duplicates
+ */
+WindowGraph::WindowGraph(parlay::sequence<uint64_t> vertices,
+                         const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) : vertices(std::move(vertices)) {
+    auto simple = parlay::filter(pairs, [](const std::pair<uint64_t, uint64_t> &pair) {
+        return pair.first != pair.second;
+    });
+    auto directed = parlay::tabulate(2 * simple.size(), [&](size_t i) {
+        const auto &pair = simple[i / 2];
+        uint64_t a = indexOf(pair.first);
+        uint64_t b = indexOf(pair.second);
+        return i % 2 == 0 ? std::make_pair(a, b) : std::make_pair(b, a);
+    });
+    parlay::sort_inplace(directed);
+
+    size_t n = this->vertices.size();
+    offsets = parlay::tabulate(n + 1, [&](size_t i) -> uint64_t {
+        auto it = std::lower_bound(directed.begin(), directed.end(), std::make_pair(uint64_t(i), uint64_t(0)));
+        return it - directed.begin();
+    });
+    adjacency = parlay::map(directed, [](const std::pair<uint64_t, uint64_t> &edge) { return edge.second; });
+}
+
+size_t WindowGraph::numVertices() const {
+    return vertices.size();
+}
+
+/**
+ * @return number of undirected edges
+ */
+size_t WindowGraph::numEdges() const {
+    return adjacency.size() / 2;
+}
+
+uint64_t WindowGraph::vertexId(uint64_t index) const {
+    return vertices[index];
+}
+
+/**
+ * @param vertex
+ * @return index of @p vertex, or max uint64 if it has no edge in the window
+ */
+uint64_t WindowGraph::indexOf(uint64_t vertex) const {
+    auto it = std::lower_bound(vertices.begin(), vertices.end(), vertex);
+    if (it == vertices.end() || *it != vertex) return std::numeric_limits<uint64_t>::max();
+    return it - vertices.begin();
+}
+
+uint64_t WindowGraph::degree(uint64_t index) const {
+    return offsets[index + 1] - offsets[index];
+}
+
+/**
+ * @param index of a vertex
+ * @return sorted indices of the neighbours of the vertex
+ */
+NeighbourSpan WindowGraph::neighbours(uint64_t index) const {
+    const uint64_t *data = adjacency.data();
+    return NeighbourSpan(data + offsets[index], data + offsets[index + 1]);
+}
+
+const parlay::sequence<uint64_t> &WindowGraph::getVertices() const {
+    return vertices;
+}
+
+/**
+ * Direction optimizing breadth first search. Small frontiers are kept as a list of indices and expanded top down,
+ * every unvisited neighbour is claimed with a compare and swap on its parent. Once a frontier and its edges exceed
+ * 1/denseDivisor of the graph it is converted into a bitmap and expanded bottom up: every unvisited vertex scans its
+ * neighbours until it finds one in the frontier. A task owns one 64 bit word of the next bitmap, so no atomics are
+ * needed there.
+ * @param source id of the start vertex
+ * @param maxDepth number of levels after which the search stops, for k hop neighbourhoods
+ * @return distances and parents of all vertices
+ */
+BfsResult WindowGraph::bfs(uint64_t source, uint64_t maxDepth) const {
+    constexpr uint64_t none = std::numeric_limits<uint64_t>::max();
+    size_t n = numVertices();
+    size_t words = (n + 63) / 64;
+    BfsResult result;
+    result.distances = parlay::sequence<uint64_t>(n, none);
+    std::vector<std::atomic<uint64_t>> parents(n);
+    parlay::parallel_for(0, n, [&](size_t i) { parents[i].store(none, std::memory_order_relaxed); });
+
+    uint64_t start = indexOf(source);
+    if (start != none) {
+        parents[start] = start;
+        result.distances[start] = 0;
+    }
+    parlay::sequence<uint64_t> frontier;
+    if (start != none) frontier.push_back(start);
+    parlay::sequence<uint64_t> bits;
+    bool dense = false;
+    uint64_t frontierSize = frontier.size();
+
+    while (frontierSize > 0 && result.levels < maxDepth) {
+        uint64_t depth = result.levels + 1;
+        uint64_t frontierEdges = dense
+                ? parlay::reduce(parlay::delayed_tabulate(n, [&](size_t i) -> uint64_t {
+                    return (bits[i / 64] >> (i % 64) & 1) ? degree(i) : 0;
+                }))
+                : parlay::reduce(parlay::delayed_map(frontier, [&](uint64_t v) { return degree(v); }));
+
+        if (frontierSize + frontierEdges > adjacency.size() / denseDivisor) {
+            if (!dense) {
+                parlay::sequence<bool> flags(n, false);
+                parlay::parallel_for(0, frontier.size(), [&](size_t i) { flags[frontier[i]] = true; });
+                bits = parlay::tabulate(words, [&](size_t w) {
+                    uint64_t word = 0;
+                    for (size_t i = w * 64; i < std::min(n, w * 64 + 64); i++) word |= uint64_t(flags[i]) << (i % 64);
+                    return word;
+                });
+                dense = true;
+            }
+            bits = parlay::tabulate(words, [&](size_t w) {
+                uint64_t word = 0;
+                for (size_t v = w * 64; v < std::min(n, w * 64 + 64); v++) {
+                    if (parents[v].load(std::memory_order_relaxed) != none) continue;
+                    for (uint64_t u: neighbours(v)) {
+                        if (bits[u / 64] >> (u % 64) & 1) {
+                            parents[v].store(u, std::memory_order_relaxed);
+                            result.distances[v] = depth;
+                            word |= uint64_t(1) << (v % 64);
+                            break;
+                        }
+                    }
+                }
+                return word;
+            });
+            frontierSize = parlay::reduce(parlay::delayed_map(bits, [](uint64_t word) -> uint64_t {
+                return __builtin_popcountll(word);
+            }));
+        } else {
+            if (dense) {
+                frontier = parlay::pack_index<uint64_t>(parlay::delayed_tabulate(n, [&](size_t i) -> bool {
+                    return bits[i / 64] >> (i % 64) & 1;
+                }));
+                dense = false;
+            }
+            auto next = parlay::map(frontier, [&](uint64_t u) {
+                parlay::sequence<uint64_t> claimed;
+                for (uint64_t v: neighbours(u)) {
+                    uint64_t expected = none;
+                    if (parents[v].load(std::memory_order_relaxed) == none &&
+                        parents[v].compare_exchange_strong(expected, u)) {
+                        result.distances[v] = depth;
+                        claimed.push_back(v);
+                    }
+                }
+                return claimed;
+            });
+            frontier = parlay::flatten(next);
+            frontierSize = frontier.size();
+        }
+        result.levels = depth;
+    }
+    result.parents = parlay::tabulate(n, [&](size_t i) { return parents[i].load(); });
+    return result;
+}
+
+/**
+ * Sorts the pairs with the smaller vertex first and counts how often every pair occurs, self loops are dropped.
+ * @param pairs edges as vertex pairs
+ * @return distinct sorted pairs with their number of occurrences
+ */
+parlay::sequence<std::pair<std::pair<uint64_t, uint64_t>, uint64_t>>
+countOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs) {
+    auto sorted = parlay::map(parlay::filter(pairs, [](const std::pair<uint64_t, uint64_t> &pair) {
+        return pair.first != pair.second;
+    }), [](const std::pair<uint64_t, uint64_t> &pair) {
+        return std::make_pair(std::min(pair.first, pair.second), std::max(pair.first, pair.second));
+    });
+    parlay::sort_inplace(sorted);
+    auto starts = parlay::pack_index(parlay::tabulate(sorted.size() + 1, [&](size_t i) {
+        return i == 0 || i == sorted.size() || sorted[i] != sorted[i - 1];
+    }));
+    return parlay::tabulate(starts.size() - 1, [&](size_t i) {
+        return std::make_pair(sorted[starts[i]], uint64_t(starts[i + 1] - starts[i]));
+    });
+}
@@ -0,0 +1,53 @@
+#ifndef TEMPUS_WINDOW_GRAPH_H
+#define TEMPUS_WINDOW_GRAPH_H
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include "parlay/sequence.h"
+#include "parlay/slice.h"
+
+typedef parlay::slice<const uint64_t*, const uint64_t*> NeighbourSpan;
+
+/**
+ * Result of a breadth first search, indexed like the vertices of the searched WindowGraph. Vertices that are not
+ * reached have distance and parent max uint64, the source is its own parent.
+ */
+struct BfsResult{
+    parlay::sequence<uint64_t> distances;
+    parlay::sequence<uint64_t> parents;
+    //number of frontiers that were expanded
+    uint64_t levels = 0;
+};
+
+/**
+ * Static CSR copy of the simple undirected graph of a window. Vertices are numbered densely in ascending order of
+ * their id, every edge that exists at one or more timestamps of the window is stored once per direction and
+ * self loops are dropped. Neighbour lists are sorted by index.
+ */
+class WindowGraph{
+public:
+    WindowGraph() = default;
+    WindowGraph(parlay::sequence<uint64_t> vertices, const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+    size_t numVertices() const;
+    size_t numEdges() const;
+    uint64_t vertexId(uint64_t index) const;
+    uint64_t indexOf(uint64_t vertex) const;
+    uint64_t degree(uint64_t index) const;
+    NeighbourSpan neighbours(uint64_t index) const;
+    const parlay::sequence<uint64_t> &getVertices() const;
+    BfsResult bfs(uint64_t source, uint64_t maxDepth = std::numeric_limits<uint64_t>::max()) const;
+
+private:
+    //a frontier is expanded bottom up once it and its edges exceed this share of all edges, as in ligra
+    static constexpr uint64_t denseDivisor = 20;
+
+    parlay::sequence<uint64_t> vertices;
+    parlay::sequence<uint64_t> offsets;
+    parlay::sequence<uint64_t> adjacency;
+};
+
+parlay::sequence<std::pair<std::pair<uint64_t, uint64_t>, uint64_t>>
+countOccurrences(const parlay::sequence<std::pair<uint64_t, uint64_t>> &pairs);
+
+#endif //TEMPUS_WINDOW_GRAPH_H